@@ -0,0 +1,206 @@
+#include "DebugCounters.h"
+
+#include "DebugSettings.h"
+#include "Engine/Engine.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommand DumpDebugCountersCommand(
+	TEXT("Debug.DumpCounters"),
+	TEXT("Logs the emitted, suppressed and rate limited debug message counts of every tag."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FDebugCounters::Get().DumpToLog();
+	}));
+
+static FAutoConsoleCommand ResetDebugCountersCommand(
+	TEXT("Debug.ResetCounters"),
+	TEXT("Resets the debug message counters of every tag."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FDebugCounters::Get().Reset();
+	}));
+
+FDebugCounters& FDebugCounters::Get()
+{
+	static FDebugCounters Instance;
+	return Instance;
+}
+
+bool FDebugCounters::TryEmit(const FGameplayTag DebugTag, const EDebugDisplayType DebugType, const bool bShown)
+{
+	return TryEmit(FindOrAddState(DebugTag), DebugType, bShown);
+}
+
+bool FDebugCounters::TryEmit(FDebugCounterSite& Site, const FGameplayTag DebugTag, const EDebugDisplayType DebugType, const bool bShown)
+{
+	//Sites usually log a single tag, the state is only looked up when it changes
+	FTagState* State = Site.CachedState.load(std::memory_order_acquire);
+	if (!State || State->DebugTag != DebugTag)
+	{
+		State = &FindOrAddState(DebugTag);
+		Site.CachedState.store(State, std::memory_order_release);
+	}
+	return TryEmit(*State, DebugType, bShown);
+}
+
+bool FDebugCounters::TryEmit(FTagState& State, const EDebugDisplayType DebugType, const bool bShown)
+{
+	if (!bShown)
+	{
+		State.Suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	const uint32 SettingsVersion = UDebugSettings::GetFilterVersion();
+	if (State.SettingsVersion.load(std::memory_order_relaxed) != SettingsVersion)
+	{
+		State.MaxPerSecond.store(UDebugSettings::Get() ? UDebugSettings::Get()->GetMaxMessagesPerSecond(State.DebugTag) : 0, std::memory_order_relaxed);
+		State.SettingsVersion.store(SettingsVersion, std::memory_order_relaxed);
+	}
+
+	const int32 MaxPerSecond = State.MaxPerSecond.load(std::memory_order_relaxed);
+	if (MaxPerSecond <= 0)
+	{
+		State.Emitted.fetch_add(1, std::memory_order_relaxed);
+		return true;
+	}
+
+	//The thread that moves the window to the current second restarts its count
+	FTagState::FRateWindow& Window = State.Windows[static_cast<int32>(DebugType) % NumDisplayTypes];
+	const int64 Second = static_cast<int64>(FPlatformTime::Seconds());
+	int64 WindowSecond = Window.Second.load(std::memory_order_relaxed);
+	if (WindowSecond != Second && Window.Second.compare_exchange_strong(WindowSecond, Second, std::memory_order_relaxed))
+		Window.Count.store(0, std::memory_order_relaxed);
+
+	if (Window.Count.fetch_add(1, std::memory_order_relaxed) >= MaxPerSecond)
+	{
+		Window.PendingRepeats.fetch_add(1, std::memory_order_relaxed);
+		State.RateLimited.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	State.Emitted.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+FDebugCounters::FTagState& FDebugCounters::FindOrAddState(const FGameplayTag DebugTag)
+{
+	{
+		FReadScopeLock ReadLock(Lock);
+		if (const TUniquePtr<FTagState>* State = TagStates.Find(DebugTag))
+			return **State;
+	}
+
+	FWriteScopeLock WriteLock(Lock);
+	TUniquePtr<FTagState>& State = TagStates.FindOrAdd(DebugTag);
+	if (!State)
+		State = MakeUnique<FTagState>(DebugTag);
+	return *State;
+}
+
+FDebugTagCounters FDebugCounters::FTagState::GetCounters() const
+{
+	FDebugTagCounters Counters;
+	Counters.Emitted = Emitted.load(std::memory_order_relaxed);
+	Counters.Suppressed = Suppressed.load(std::memory_order_relaxed);
+	Counters.RateLimited = RateLimited.load(std::memory_order_relaxed);
+	return Counters;
+}
+
+void FDebugCounters::FTagState::Reset()
+{
+	Emitted.store(0, std::memory_order_relaxed);
+	Suppressed.store(0, std::memory_order_relaxed);
+	RateLimited.store(0, std::memory_order_relaxed);
+	for (FRateWindow& Window : Windows)
+	{
+		Window.Count.store(0, std::memory_order_relaxed);
+		Window.PendingRepeats.store(0, std::memory_order_relaxed);
+	}
+}
+
+FDebugTagCounters FDebugCounters::GetCounters(const FGameplayTag DebugTag) const
+{
+	FReadScopeLock ReadLock(Lock);
+	const TUniquePtr<FTagState>* State = TagStates.Find(DebugTag);
+	return State ? (*State)->GetCounters() : FDebugTagCounters();
+}
+
+TMap<FGameplayTag, FDebugTagCounters> FDebugCounters::GetAllCounters() const
+{
+	FReadScopeLock ReadLock(Lock);
+	TMap<FGameplayTag, FDebugTagCounters> AllCounters;
+	AllCounters.Reserve(TagStates.Num());
+	for (const TPair<FGameplayTag, TUniquePtr<FTagState>>& Pair : TagStates)
+		AllCounters.Add(Pair.Key, Pair.Value->GetCounters());
+	return AllCounters;
+}
+
+void FDebugCounters::Reset()
+{
+	//Call sites keep pointing at the states, so they are only zeroed
+	FReadScopeLock ReadLock(Lock);
+	for (const TPair<FGameplayTag, TUniquePtr<FTagState>>& Pair : TagStates)
+		Pair.Value->Reset();
+}
+
+void FDebugCounters::FlushRepeatSummaries()
+{
+	check(IsInGameThread());
+
+	struct FRepeatSummary
+	{
+		FGameplayTag DebugTag;
+		EDebugDisplayType DebugType;
+		int32 Repeats;
+	};
+
+	//Collected first so the log and screen output happen outside the lock
+	TArray<FRepeatSummary> Summaries;
+	{
+		FReadScopeLock ReadLock(Lock);
+		for (const TPair<FGameplayTag, TUniquePtr<FTagState>>& Pair : TagStates)
+		{
+			for (int32 TypeIndex = 0; TypeIndex < NumDisplayTypes; TypeIndex++)
+			{
+				const int32 Repeats = Pair.Value->Windows[TypeIndex].PendingRepeats.exchange(0, std::memory_order_relaxed);
+				if (Repeats > 0)
+					Summaries.Add({Pair.Key, static_cast<EDebugDisplayType>(TypeIndex), Repeats});
+			}
+		}
+	}
+
+	for (const FRepeatSummary& Summary : Summaries)
+	{
+		const FString Text = FString::Printf(TEXT("[%s] x%d repeated messages rate limited"), *Summary.DebugTag.ToString(), Summary.Repeats);
+		switch (Summary.DebugType)
+		{
+			case EDebugDisplayType::Log:
+				UE_LOG(LogTemp, Warning, TEXT("%s"), *Text);
+				break;
+			case EDebugDisplayType::Print:
+				if (GEngine)
+					GEngine->AddOnScreenDebugMessage(-1, 1.f, FColor::Yellow, Text);
+				break;
+			default:
+				break;
+		}
+	}
+}
+
+void FDebugCounters::DumpToLog() const
+{
+	TMap<FGameplayTag, FDebugTagCounters> AllCounters = GetAllCounters();
+	AllCounters.KeySort([](const FGameplayTag& A, const FGameplayTag& B)
+	{
+		return A.GetTagName().LexicalLess(B.GetTagName());
+	});
+
+	UE_LOG(LogTemp, Log, TEXT("%-48s %12s %12s %12s"), TEXT("Tag"), TEXT("Emitted"), TEXT("Suppressed"), TEXT("RateLimited"));
+	for (const TPair<FGameplayTag, FDebugTagCounters>& Pair : AllCounters)
+	{
+		UE_LOG(LogTemp, Log, TEXT("%-48s %12lld %12lld %12lld"),
+			Pair.Key.IsValid() ? *Pair.Key.ToString() : TEXT("(None)"),
+			Pair.Value.Emitted, Pair.Value.Suppressed, Pair.Value.RateLimited);
+	}
+}
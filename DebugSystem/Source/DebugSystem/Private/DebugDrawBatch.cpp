@@ -0,0 +1,198 @@
+#include "DebugDrawBatch.h"
+
+#include "DebugFunctionLibrary.h"
+#include "DrawDebugHelpers.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+namespace DebugDrawBatch
+{
+	using FFrameBatchKey = TPair<TWeakObjectPtr<UWorld>, FGameplayTag>;
+
+	static TMap<FFrameBatchKey, TUniquePtr<FDebugDrawBatch>>& GetFrameBatches()
+	{
+		static TMap<FFrameBatchKey, TUniquePtr<FDebugDrawBatch>> FrameBatches;
+		return FrameBatches;
+	}
+
+	static ULineBatchComponent* GetLineBatcher(UWorld* World, const float Duration)
+	{
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION >= 5
+		return World->GetLineBatcher(Duration > 0.f ? UWorld::ELineBatcherType::WorldPersistent : UWorld::ELineBatcherType::World);
+#else
+		return Duration > 0.f ? World->PersistentLineBatcher : World->LineBatcher;
+#endif
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs BenchmarkDebugDrawCommand(
+	TEXT("Debug.BenchmarkDraw"),
+	TEXT("Compares drawing debug spheres one by one and batched. Usage: Debug.BenchmarkDraw [Count] [DebugTag]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		const int32 Count = Args.IsEmpty() ? 10000 : FCString::Atoi(*Args[0]);
+		const FGameplayTag DebugTag = Args.Num() > 1 ? FGameplayTag::RequestGameplayTag(FName(*Args[1]), false) : FGameplayTag();
+
+		//Both loops would only time the filter check
+		if (!UDebugFunctionLibrary::ShouldDebug(DebugTag, EDebugDisplayType::Visual))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("BenchmarkDraw: Visual debugs are disabled for tag %s, enable them in the debug settings or pass another tag."),
+				DebugTag.IsValid() ? *DebugTag.ToString() : TEXT("None"));
+			return;
+		}
+
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Count; Index++)
+			UDebugFunctionLibrary::DebugDrawSphere(World, DebugTag, FVector(Index * 10.f, 0.f, 0.f), 10.f, 8);
+		const double PerCallMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		StartTime = FPlatformTime::Seconds();
+		{
+			FDebugDrawBatch Batch(World, DebugTag);
+			for (int32 Index = 0; Index < Count; Index++)
+				Batch.AddSphere(FVector(Index * 10.f, 100.f, 0.f), 10.f, 8, FLinearColor::White);
+		}
+		const double BatchedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		UE_LOG(LogTemp, Log, TEXT("BenchmarkDraw: %d spheres, per call %.3f ms, batched %.3f ms"), Count, PerCallMs, BatchedMs);
+	}));
+
+FDebugDrawBatch::FDebugDrawBatch(const UObject* WorldContextObject, const FGameplayTag InDebugTag)
+	: World(GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr)
+	, DebugTag(InDebugTag)
+{
+	RefreshFilter();
+}
+
+FDebugDrawBatch::~FDebugDrawBatch()
+{
+	Submit();
+}
+
+void FDebugDrawBatch::AddLine(const FVector& Start, const FVector& End, const FLinearColor& Color, const float Thickness)
+{
+	if (bEnabled)
+		Lines.Emplace(Start, End, Color, Duration, Thickness, SDPG_World);
+}
+
+void FDebugDrawBatch::AddSphere(const FVector& Center, const float Radius, int32 Segments, const FLinearColor& Color, const float Thickness)
+{
+	if (!bEnabled)
+		return;
+
+	//Same lines as DrawDebugSphere
+	Segments = FMath::Max(Segments, 4);
+	const float AngleInc = 2.f * UE_PI / Segments;
+	Lines.Reserve(Lines.Num() + Segments * Segments * 2);
+
+	float SinY1 = 0.0f;
+	float CosY1 = 1.0f;
+	float Latitude = AngleInc;
+	for (int32 SegmentY = 0; SegmentY < Segments; SegmentY++)
+	{
+		const float SinY2 = FMath::Sin(Latitude);
+		const float CosY2 = FMath::Cos(Latitude);
+
+		FVector Vertex1 = FVector(SinY1, 0.0f, CosY1) * Radius + Center;
+		FVector Vertex3 = FVector(SinY2, 0.0f, CosY2) * Radius + Center;
+		float Longitude = AngleInc;
+		for (int32 SegmentX = 0; SegmentX < Segments; SegmentX++)
+		{
+			const float SinX = FMath::Sin(Longitude);
+			const float CosX = FMath::Cos(Longitude);
+
+			const FVector Vertex2 = FVector(CosX * SinY1, SinX * SinY1, CosY1) * Radius + Center;
+			const FVector Vertex4 = FVector(CosX * SinY2, SinX * SinY2, CosY2) * Radius + Center;
+
+			Lines.Emplace(Vertex1, Vertex2, Color, Duration, Thickness, SDPG_World);
+			Lines.Emplace(Vertex1, Vertex3, Color, Duration, Thickness, SDPG_World);
+
+			Vertex1 = Vertex2;
+			Vertex3 = Vertex4;
+			Longitude += AngleInc;
+		}
+		SinY1 = SinY2;
+		CosY1 = CosY2;
+		Latitude += AngleInc;
+	}
+}
+
+void FDebugDrawBatch::AddArrow(const FVector& Start, const FVector& End, const float ArrowSize, const FLinearColor& Color, const float Thickness)
+{
+	if (!bEnabled)
+		return;
+
+	//Same lines as DrawDebugDirectionalArrow
+	Lines.Emplace(Start, End, Color, Duration, Thickness, SDPG_World);
+
+	FVector Direction = (End - Start).GetSafeNormal();
+	FVector Up(0, 0, 1);
+	FVector Right = Direction ^ Up;
+	if (!Right.IsNormalized())
+		Direction.FindBestAxisVectors(Up, Right);
+
+	const FVector Origin = FVector::ZeroVector;
+	FMatrix Transform;
+	Transform.SetAxes(&Direction, &Right, &Up, &Origin);
+
+	const float ArrowSqrt = FMath::Sqrt(ArrowSize);
+	Lines.Emplace(End, End + Transform.TransformPosition(FVector(-ArrowSqrt, ArrowSqrt, 0)), Color, Duration, Thickness, SDPG_World);
+	Lines.Emplace(End, End + Transform.TransformPosition(FVector(-ArrowSqrt, -ArrowSqrt, 0)), Color, Duration, Thickness, SDPG_World);
+}
+
+void FDebugDrawBatch::AddString(const FVector& TextLocation, const FString& Text, AActor* TestBaseActor, const FLinearColor& Color, const float InDuration)
+{
+	if (bEnabled)
+		DrawDebugString(World.Get(), TextLocation, Text, TestBaseActor, Color.ToFColor(true), InDuration);
+}
+
+void FDebugDrawBatch::Submit()
+{
+	if (Lines.IsEmpty())
+		return;
+
+	if (UWorld* CurrentWorld = World.Get())
+	{
+		if (ULineBatchComponent* LineBatcher = DebugDrawBatch::GetLineBatcher(CurrentWorld, Duration))
+			LineBatcher->DrawLines(Lines);
+	}
+
+	Lines.Reset();
+}
+
+FDebugDrawBatch& FDebugDrawBatch::GetFrameBatch(const UObject* WorldContextObject, const FGameplayTag DebugTag)
+{
+	UWorld* World = GEngine ? GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull) : nullptr;
+
+	TUniquePtr<FDebugDrawBatch>& Batch = DebugDrawBatch::GetFrameBatches().FindOrAdd({World, DebugTag});
+	if (!Batch.IsValid())
+		Batch = MakeUnique<FDebugDrawBatch>(World, DebugTag);
+	else if (Batch->FilterFrame != GFrameCounter)
+		Batch->RefreshFilter();
+
+	return *Batch;
+}
+
+void FDebugDrawBatch::SubmitFrameBatches(const UWorld* World)
+{
+	for (auto It = DebugDrawBatch::GetFrameBatches().CreateIterator(); It; ++It)
+	{
+		if (!It->Key.Key.IsValid())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+
+		if (It->Key.Key == World)
+			It->Value->Submit();
+	}
+}
+
+void FDebugDrawBatch::RefreshFilter()
+{
+	FilterFrame = GFrameCounter;
+	bEnabled = World.IsValid() && UDebugFunctionLibrary::ShouldDebug(DebugTag, EDebugDisplayType::Visual);
+	Duration = bEnabled ? UDebugFunctionLibrary::GetDebugDuration(DebugTag, EDebugDisplayType::Visual) : 0.f;
+}
@@ -1,4 +1,5 @@
 #include "DebugFunctionLibrary.h"
+#include "DebugDrawBatch.h"
 #include "DebugSettings.h"
 #include "Kismet/KismetSystemLibrary.h"
 
@@ -21,6 +22,31 @@ bool UDebugFunctionLibrary::ShouldDebug(const FGameplayTag DebugTag, const EDebu
 #endif
 }
 
+bool UDebugFunctionLibrary::ShouldEmitDebug(const FGameplayTag DebugTag, const EDebugDisplayType DebugType)
+{
+	return FDebugCounters::Get().TryEmit(DebugTag, DebugType, ShouldDebug(DebugTag, DebugType));
+}
+
+bool UDebugFunctionLibrary::ShouldEmitDebug(const FGameplayTag DebugTag, const EDebugDisplayType DebugType, FDebugCounterSite& Site)
+{
+	return FDebugCounters::Get().TryEmit(Site, DebugTag, DebugType, ShouldDebug(DebugTag, DebugType));
+}
+
+FDebugTagCounters UDebugFunctionLibrary::GetDebugCounters(const FGameplayTag DebugTag)
+{
+	return FDebugCounters::Get().GetCounters(DebugTag);
+}
+
+TMap<FGameplayTag, FDebugTagCounters> UDebugFunctionLibrary::GetAllDebugCounters()
+{
+	return FDebugCounters::Get().GetAllCounters();
+}
+
+FDebugTimingStats UDebugFunctionLibrary::GetDebugTimingStats(const FGameplayTag DebugTag)
+{
+	return FDebugTimingSite::GetStats(DebugTag);
+}
+
 float UDebugFunctionLibrary::GetDebugDuration(FGameplayTag DebugTag, EDebugDisplayType DebugType)
 {
 	if (GetDefault<UDebugSettings>())
@@ -39,8 +65,10 @@ void UDebugFunctionLibrary::DebugString(
 	// const float Duration,
 	const FName Key) 
 {
-	const bool bShouldPrintToScreen = /*bPrintToScreen &&*/ ShouldDebug(InDebugTag,EDebugDisplayType::Print);
-	const bool bShouldPrintToLog = /*bPrintToLog &&*/ ShouldDebug(InDebugTag,EDebugDisplayType::Log);
+	const bool bShouldPrintToScreen = /*bPrintToScreen &&*/ ShouldEmitDebug(InDebugTag,EDebugDisplayType::Print);
+	const bool bShouldPrintToLog = /*bPrintToLog &&*/ ShouldEmitDebug(InDebugTag,EDebugDisplayType::Log);
+	if (FDebugRingBuffer::Get().ShouldRecord(bShouldPrintToScreen || bShouldPrintToLog))
+		FDebugRingBuffer::Get().Record(InDebugTag, ELogVerbosity::Log, *InString);
 	if (!bShouldPrintToScreen && !bShouldPrintToLog)
 		return;
 
@@ -65,11 +93,17 @@ void UDebugFunctionLibrary::ThrowError(const UObject* WorldContextObject, const
 
 void UDebugFunctionLibrary::DebugError(const UObject* WorldContextObject, const FString& ErrorMessage, const bool bPrintToScreen, const bool bPrintToLog)
 {
+		bool bSuppressed = false;
 		if (const UDebugSettings* Settings = GetDefault<UDebugSettings>())
-		{
-			if (Settings->SuppressAllDebugs())
-				return;
-		}
+			bSuppressed = Settings->SuppressAllDebugs();
+
+		//Errors have no tag, they are counted and rate limited under the empty tag
+		const bool bEmitToScreen = bPrintToScreen && FDebugCounters::Get().TryEmit(FGameplayTag(), EDebugDisplayType::Print, !bSuppressed);
+		const bool bEmitToLog = bPrintToLog && FDebugCounters::Get().TryEmit(FGameplayTag(), EDebugDisplayType::Log, !bSuppressed);
+		if (FDebugRingBuffer::Get().ShouldRecord(bEmitToScreen || bEmitToLog))
+			FDebugRingBuffer::Get().Record(FGameplayTag(), ELogVerbosity::Error, *ErrorMessage);
+		if (!bEmitToScreen && !bEmitToLog)
+			return;
 	
 		if (!IsValid(WorldContextObject))
 		{
@@ -88,7 +122,7 @@ void UDebugFunctionLibrary::DebugError(const UObject* WorldContextObject, const
 		);
 	
 		constexpr float Duration = 400.f;
-		UKismetSystemLibrary::PrintString(WorldContextObject, StringToPrint, bPrintToScreen, bPrintToLog, FColor::Red, Duration);
+		UKismetSystemLibrary::PrintString(WorldContextObject, StringToPrint, bEmitToScreen, bEmitToLog, FColor::Red, Duration);
 }
 
 void UDebugFunctionLibrary::DebugDrawSphere(
@@ -133,6 +167,29 @@ void UDebugFunctionLibrary::DebugDrawString(const UObject* WorldContextObject, c
 		UKismetSystemLibrary::DrawDebugString(WorldContextObject,TextLocation,Text,TestBaseActor,TextColor,Duration);
 }
 
+void UDebugFunctionLibrary::BatchedDebugDrawSphere(const UObject* WorldContextObject, const FGameplayTag DebugTag, const FVector Center,
+	const float Radius, const int32 Segments, const FLinearColor LineColor, const float Thickness)
+{
+	FDebugDrawBatch::GetFrameBatch(WorldContextObject, DebugTag).AddSphere(Center, Radius, Segments, LineColor, Thickness);
+}
+
+void UDebugFunctionLibrary::BatchedDebugDrawArrow(const UObject* WorldContextObject, const FGameplayTag DebugTag, const FVector Start, const FVector End,
+	const int32 Segments, const FLinearColor LineColor, const float Thickness)
+{
+	FDebugDrawBatch::GetFrameBatch(WorldContextObject, DebugTag).AddArrow(Start, End, Segments, LineColor, Thickness);
+}
+
+void UDebugFunctionLibrary::BatchedDebugDrawString(const UObject* WorldContextObject, const FGameplayTag DebugTag, const FVector TextLocation,
+	const FString& Text, AActor* TestBaseActor, const FLinearColor TextColor, const float Duration)
+{
+	FDebugDrawBatch::GetFrameBatch(WorldContextObject, DebugTag).AddString(TextLocation, Text, TestBaseActor, TextColor, Duration);
+}
+
+bool UDebugFunctionLibrary::DumpDebugRingBuffer(const FString& FilePath)
+{
+	return FDebugRingBuffer::Get().DumpToFile(FilePath.IsEmpty() ? FDebugRingBuffer::GetDefaultDumpPath() : FilePath);
+}
+
 FString UDebugFunctionLibrary::GetAdditivePIEText()
 {
 	FString Text = "";
@@ -0,0 +1,112 @@
+#include "DebugRingBuffer.h"
+
+#include "DebugSettings.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+static FAutoConsoleCommand DumpDebugRingBufferCommand(
+	TEXT("Debug.DumpRingBuffer"),
+	TEXT("Writes the last debug messages to a file. Usage: Debug.DumpRingBuffer [FilePath]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		const FString FilePath = Args.IsEmpty() ? FDebugRingBuffer::GetDefaultDumpPath() : Args[0];
+		if (FDebugRingBuffer::Get().DumpToFile(FilePath))
+			UE_LOG(LogTemp, Log, TEXT("DumpRingBuffer: Written to %s"), *FilePath);
+	}));
+
+FDebugRingBuffer& FDebugRingBuffer::Get()
+{
+	static FDebugRingBuffer Instance = []()
+	{
+		const UDebugSettings* Settings = UDebugSettings::Get();
+		return FDebugRingBuffer(Settings ? Settings->GetRingBufferCapacity() : 0, Settings && Settings->ShouldRingBufferRecordSuppressed());
+	}();
+	return Instance;
+}
+
+FDebugRingBuffer::FDebugRingBuffer(const int32 InCapacity, const bool bInRecordSuppressed)
+	: Capacity(FMath::Max(InCapacity, 0))
+	, bRecordSuppressed(bInRecordSuppressed)
+{
+	if (Capacity > 0)
+		Slots = MakeUnique<FSlot[]>(Capacity);
+}
+
+void FDebugRingBuffer::Record(const FGameplayTag DebugTag, const ELogVerbosity::Type Verbosity, const TCHAR* Text)
+{
+	if (Capacity == 0)
+		return;
+
+	const uint64 Index = WriteIndex.fetch_add(1, std::memory_order_relaxed);
+	FSlot& Slot = Slots[Index % Capacity];
+
+	//Claim the slot before writing. It is skipped if another writer still holds it after the buffer wrapped around,
+	//or if a newer message already took it, so two writers never write the same slot at once
+	uint64 Sequence = Slot.Sequence.load(std::memory_order_relaxed);
+	do
+	{
+		if ((Sequence & 1) != 0 || Sequence > 2 * Index)
+			return;
+	}
+	while (!Slot.Sequence.compare_exchange_weak(Sequence, 2 * Index + 1, std::memory_order_relaxed));
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Slot.DebugTag = DebugTag;
+	Slot.Verbosity = Verbosity;
+	Slot.TimeTicks = FDateTime::UtcNow().GetTicks();
+	FCString::Strncpy(Slot.Text, Text ? Text : TEXT(""), MaxMessageLength);
+
+	Slot.Sequence.store(2 * (Index + 1), std::memory_order_release);
+}
+
+bool FDebugRingBuffer::DumpToFile(const FString& FilePath) const
+{
+	if (Capacity == 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("DumpRingBuffer: The debug ring buffer is disabled."));
+		return false;
+	}
+
+	const uint64 EndIndex = WriteIndex.load(std::memory_order_acquire);
+	const uint64 StartIndex = EndIndex > static_cast<uint64>(Capacity) ? EndIndex - Capacity : 0;
+
+	FString Output;
+	Output.Reserve(static_cast<int32>(EndIndex - StartIndex) * 128);
+	for (uint64 Index = StartIndex; Index < EndIndex; Index++)
+	{
+		const FSlot& Slot = Slots[Index % Capacity];
+		if (Slot.Sequence.load(std::memory_order_acquire) != 2 * (Index + 1))
+			continue;
+
+		const FGameplayTag DebugTag = Slot.DebugTag;
+		const ELogVerbosity::Type Verbosity = Slot.Verbosity;
+		const int64 TimeTicks = Slot.TimeTicks;
+		TCHAR Text[MaxMessageLength];
+		FMemory::Memcpy(Text, Slot.Text, sizeof(Text));
+		Text[MaxMessageLength - 1] = TEXT('\0');
+
+		//Overwritten while copying
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (Slot.Sequence.load(std::memory_order_relaxed) != 2 * (Index + 1))
+			continue;
+
+		Output += FString::Printf(TEXT("[%s][%s][%s] %s\n"),
+			*FDateTime(TimeTicks).ToString(TEXT("%Y.%m.%d-%H.%M.%S:%s")),
+			ToString(Verbosity),
+			DebugTag.IsValid() ? *DebugTag.ToString() : TEXT("None"),
+			Text);
+	}
+
+	if (!FFileHelper::SaveStringToFile(Output, *FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("DumpRingBuffer: Failed to write %s"), *FilePath);
+		return false;
+	}
+	return true;
+}
+
+FString FDebugRingBuffer::GetDefaultDumpPath()
+{
+	return FPaths::Combine(FPaths::ProjectLogDir(), FString::Printf(TEXT("DebugRingBuffer-%s.log"), *FDateTime::Now().ToString()));
+}
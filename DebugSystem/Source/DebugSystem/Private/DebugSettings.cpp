@@ -1,5 +1,12 @@
 #include "DebugSettings.h"
 
+#include <atomic>
+
+namespace DebugSettings
+{
+	static std::atomic<uint32> FilterVersion { 0 };
+}
+
 bool UDebugSettings::ShouldDebug(FGameplayTag DebugTagIn, EDebugDisplayType DebugTypeIn) const
 {
 	if(bSuppressAllDebugs)
@@ -84,16 +91,61 @@ bool UDebugSettings::SuppressAllDebugs() const
 	return bSuppressAllDebugs;
 }
 
+int32 UDebugSettings::GetMaxMessagesPerSecond(FGameplayTag DebugTag) const
+{
+	for (auto RateLimit : MaxMessagesPerSecond)
+	{
+		if (DebugTag.MatchesTag(RateLimit.Key))
+		{
+			return RateLimit.Value;
+		}
+	}
+	return DefaultMaxMessagesPerSecond;
+}
+
 UDebugSettings* UDebugSettings::Get()
 {
 	return StaticClass()->GetDefaultObject<UDebugSettings>();
 }
 
+uint32 UDebugSettings::GetFilterVersion()
+{
+	return DebugSettings::FilterVersion.load(std::memory_order_relaxed);
+}
+
+void UDebugSettings::MarkFiltersChanged()
+{
+	DebugSettings::FilterVersion.fetch_add(1, std::memory_order_relaxed);
+}
+
 FName UDebugSettings::GetCategoryName() const
 {
 	return FApp::GetProjectName();
 }
 
+void UDebugSettings::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	//Config is loaded at this point, results cached before the settings object existed are outdated
+	if (HasAnyFlags(RF_ClassDefaultObject))
+		MarkFiltersChanged();
+}
+
+void UDebugSettings::PostReloadConfig(FProperty* PropertyThatWasLoaded)
+{
+	Super::PostReloadConfig(PropertyThatWasLoaded);
+	MarkFiltersChanged();
+}
+
+#if WITH_EDITOR
+void UDebugSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	MarkFiltersChanged();
+}
+#endif
+
 bool UDebugSettings::ShouldShowDebugType(EDebugDisplayType DebugTypeIn) const
 {
 	switch (DebugTypeIn) {
@@ -1,13 +1,40 @@
 ﻿#include "DebugSystem.h"
 
+#include "DebugCounters.h"
+#include "DebugDrawBatch.h"
+#include "DebugRingBuffer.h"
+#include "DebugSettings.h"
+#include "Engine/World.h"
+#include "Misc/CoreDelegates.h"
+
 #define LOCTEXT_NAMESPACE "FDebugSystemModule"
 
 void FDebugSystemModule::StartupModule()
 {
+	//Rate limited messages are summarized once per second
+	RepeatSummaryTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda([](float)
+	{
+		FDebugCounters::Get().FlushRepeatSummaries();
+		return true;
+	}), 1.f);
+
+	SystemErrorHandle = FCoreDelegates::OnHandleSystemError.AddLambda([]()
+	{
+		if (UDebugSettings::Get() && UDebugSettings::Get()->ShouldDumpRingBufferOnCrash())
+			FDebugRingBuffer::Get().DumpToFile(FDebugRingBuffer::GetDefaultDumpPath());
+	});
+
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddLambda([](UWorld* World, ELevelTick, float)
+	{
+		FDebugDrawBatch::SubmitFrameBatches(World);
+	});
 }
 
 void FDebugSystemModule::ShutdownModule()
 {
+	FTSTicker::GetCoreTicker().RemoveTicker(RepeatSummaryTickerHandle);
+	FCoreDelegates::OnHandleSystemError.Remove(SystemErrorHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
 }
 
 #undef LOCTEXT_NAMESPACE
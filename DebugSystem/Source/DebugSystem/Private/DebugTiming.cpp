@@ -0,0 +1,132 @@
+#include "DebugTiming.h"
+
+#include "DebugFunctionLibrary.h"
+#include "HAL/IConsoleManager.h"
+
+namespace DebugTiming
+{
+	//Sites are static and never unregistered
+	static FCriticalSection SitesLock;
+	static TArray<FDebugTimingSite*>& GetSites()
+	{
+		static TArray<FDebugTimingSite*> Sites;
+		return Sites;
+	}
+}
+
+static FAutoConsoleCommand DumpDebugTimersCommand(
+	TEXT("Debug.DumpTimers"),
+	TEXT("Logs the call count, total, min and max time of every debug scope timer tag."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FDebugTimingSite::DumpToLog();
+	}));
+
+static FAutoConsoleCommand ResetDebugTimersCommand(
+	TEXT("Debug.ResetTimers"),
+	TEXT("Resets the debug scope timers of every tag."),
+	FConsoleCommandDelegate::CreateLambda([]()
+	{
+		FDebugTimingSite::ResetAllStats();
+	}));
+
+FDebugTimingSite::FDebugTimingSite(const FGameplayTag InDebugTag)
+	: DebugTag(InDebugTag)
+{
+	FScopeLock ScopeLock(&DebugTiming::SitesLock);
+	DebugTiming::GetSites().Add(this);
+}
+
+void FDebugTimingSite::AddSample(const uint64 Cycles)
+{
+	Count.fetch_add(1, std::memory_order_relaxed);
+	TotalCycles.fetch_add(Cycles, std::memory_order_relaxed);
+
+	uint64 CurrentMin = MinCycles.load(std::memory_order_relaxed);
+	while (Cycles < CurrentMin && !MinCycles.compare_exchange_weak(CurrentMin, Cycles, std::memory_order_relaxed)) {}
+
+	uint64 CurrentMax = MaxCycles.load(std::memory_order_relaxed);
+	while (Cycles > CurrentMax && !MaxCycles.compare_exchange_weak(CurrentMax, Cycles, std::memory_order_relaxed)) {}
+}
+
+void FDebugTimingSite::Reset()
+{
+	Count.store(0, std::memory_order_relaxed);
+	TotalCycles.store(0, std::memory_order_relaxed);
+	MinCycles.store(MAX_uint64, std::memory_order_relaxed);
+	MaxCycles.store(0, std::memory_order_relaxed);
+}
+
+void FDebugTimingSite::AppendStats(FDebugTimingStats& Stats) const
+{
+	const uint64 SiteCount = Count.load(std::memory_order_relaxed);
+	if (SiteCount == 0)
+		return;
+
+	const double MinMs = FPlatformTime::ToMilliseconds64(MinCycles.load(std::memory_order_relaxed));
+	const double MaxMs = FPlatformTime::ToMilliseconds64(MaxCycles.load(std::memory_order_relaxed));
+
+	Stats.MinMs = Stats.Count == 0 ? MinMs : FMath::Min(Stats.MinMs, MinMs);
+	Stats.MaxMs = FMath::Max(Stats.MaxMs, MaxMs);
+	Stats.Count += SiteCount;
+	Stats.TotalMs += FPlatformTime::ToMilliseconds64(TotalCycles.load(std::memory_order_relaxed));
+}
+
+FDebugTimingStats FDebugTimingSite::GetStats(const FGameplayTag DebugTag)
+{
+	FDebugTimingStats Stats;
+	FScopeLock ScopeLock(&DebugTiming::SitesLock);
+	for (const FDebugTimingSite* Site : DebugTiming::GetSites())
+	{
+		if (Site->DebugTag == DebugTag)
+			Site->AppendStats(Stats);
+	}
+	return Stats;
+}
+
+TMap<FGameplayTag, FDebugTimingStats> FDebugTimingSite::GetAllStats()
+{
+	TMap<FGameplayTag, FDebugTimingStats> AllStats;
+	FScopeLock ScopeLock(&DebugTiming::SitesLock);
+	for (const FDebugTimingSite* Site : DebugTiming::GetSites())
+		Site->AppendStats(AllStats.FindOrAdd(Site->DebugTag));
+	return AllStats;
+}
+
+void FDebugTimingSite::ResetAllStats()
+{
+	FScopeLock ScopeLock(&DebugTiming::SitesLock);
+	for (FDebugTimingSite* Site : DebugTiming::GetSites())
+		Site->Reset();
+}
+
+void FDebugTimingSite::DumpToLog()
+{
+	TMap<FGameplayTag, FDebugTimingStats> AllStats = GetAllStats();
+	AllStats.KeySort([](const FGameplayTag& A, const FGameplayTag& B)
+	{
+		return A.GetTagName().LexicalLess(B.GetTagName());
+	});
+
+	UE_LOG(LogTemp, Log, TEXT("%-48s %10s %12s %10s %10s %10s"), TEXT("Tag"), TEXT("Count"), TEXT("Total ms"), TEXT("Avg ms"), TEXT("Min ms"), TEXT("Max ms"));
+	for (const TPair<FGameplayTag, FDebugTimingStats>& Pair : AllStats)
+	{
+		if (Pair.Value.Count == 0)
+			continue;
+
+		UE_LOG(LogTemp, Log, TEXT("%-48s %10lld %12.3f %10.4f %10.4f %10.4f"),
+			*Pair.Key.ToString(), Pair.Value.Count, Pair.Value.TotalMs,
+			Pair.Value.TotalMs / Pair.Value.Count, Pair.Value.MinMs, Pair.Value.MaxMs);
+	}
+}
+
+uint32 FDebugTimingSite::GetSettingsVersion()
+{
+	return UDebugSettings::GetFilterVersion();
+}
+
+void FDebugTimingSite::RefreshEnabled(const uint32 SettingsVersion)
+{
+	bEnabled.store(UDebugFunctionLibrary::ShouldDebug(DebugTag, EDebugDisplayType::Log), std::memory_order_relaxed);
+	CachedSettingsVersion.store(SettingsVersion, std::memory_order_relaxed);
+}
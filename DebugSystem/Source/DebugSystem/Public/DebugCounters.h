@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "DebugDisplayType.h"
+#include "GameplayTagContainer.h"
+#include <atomic>
+#include "DebugCounters.generated.h"
+
+USTRUCT(BlueprintType)
+struct DEBUGSYSTEM_API FDebugTagCounters
+{
+	GENERATED_BODY()
+
+	//Messages that passed the filters and the rate limit
+	UPROPERTY(BlueprintReadOnly, Category = "Debug")
+	int64 Emitted = 0;
+	//Messages blocked by the debug settings filters
+	UPROPERTY(BlueprintReadOnly, Category = "Debug")
+	int64 Suppressed = 0;
+	//Messages collapsed into a repeat summary
+	UPROPERTY(BlueprintReadOnly, Category = "Debug")
+	int64 RateLimited = 0;
+};
+
+class FDebugCounterSite;
+
+/**
+ * Counts debug messages per tag and applies the per tag rate limit from UDebugSettings.
+ * Safe to use from any thread without locking once the tag was counted before, repeat summaries are emitted on the game thread.
+ */
+class DEBUGSYSTEM_API FDebugCounters
+{
+public:
+
+	static FDebugCounters& Get();
+
+	//Counts the message and returns true if it should be emitted
+	bool TryEmit(FGameplayTag DebugTag, EDebugDisplayType DebugType, bool bShown);
+	//Same, the call site remembers the counters of its tag so they are not looked up again
+	bool TryEmit(FDebugCounterSite& Site, FGameplayTag DebugTag, EDebugDisplayType DebugType, bool bShown);
+
+	FDebugTagCounters GetCounters(FGameplayTag DebugTag) const;
+	TMap<FGameplayTag, FDebugTagCounters> GetAllCounters() const;
+	void Reset();
+
+	//Emits one "xN" summary for every tag that was rate limited since the last flush
+	void FlushRepeatSummaries();
+	void DumpToLog() const;
+
+	struct FTagState;
+
+private:
+
+	static constexpr int32 NumDisplayTypes = 4;
+
+	FTagState& FindOrAddState(FGameplayTag DebugTag);
+	bool TryEmit(FTagState& State, EDebugDisplayType DebugType, bool bShown);
+
+	//States are never removed so call sites can keep pointers to them, the lock only guards the map
+	mutable FRWLock Lock;
+	TMap<FGameplayTag, TUniquePtr<FTagState>> TagStates;
+};
+
+struct FDebugCounters::FTagState
+{
+	explicit FTagState(FGameplayTag InDebugTag) : DebugTag(InDebugTag) {  }
+
+	//Rate windows are whole seconds of the platform time
+	struct FRateWindow
+	{
+		std::atomic<int64> Second { 0 };
+		std::atomic<int32> Count { 0 };
+		std::atomic<int32> PendingRepeats { 0 };
+	};
+
+	const FGameplayTag DebugTag;
+	std::atomic<int64> Emitted { 0 };
+	std::atomic<int64> Suppressed { 0 };
+	std::atomic<int64> RateLimited { 0 };
+	FRateWindow Windows[NumDisplayTypes];
+
+	//Rate limit of the tag, read from the settings again when their filter version changes
+	std::atomic<uint32> SettingsVersion { MAX_uint32 };
+	std::atomic<int32> MaxPerSecond { 0 };
+
+	FDebugTagCounters GetCounters() const;
+	void Reset();
+};
+
+//One per DEBUG_LOG and DEBUG_PRINT_TO_SCREEN call site
+class FDebugCounterSite
+{
+	friend FDebugCounters;
+	std::atomic<FDebugCounters::FTagState*> CachedState { nullptr };
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Components/LineBatchComponent.h"
+
+/**
+ * Collects debug draw primitives of one tag and submits all lines to the line batcher at once.
+ * The debug settings filter is evaluated once per batch instead of once per primitive. Game thread only.
+ */
+class DEBUGSYSTEM_API FDebugDrawBatch
+{
+public:
+
+	FDebugDrawBatch(const UObject* WorldContextObject, FGameplayTag InDebugTag);
+	~FDebugDrawBatch();
+
+	UE_NONCOPYABLE(FDebugDrawBatch);
+
+	bool IsEnabled() const { return bEnabled; }
+	int32 GetNumLines() const { return Lines.Num(); }
+
+	void AddLine(const FVector& Start, const FVector& End, const FLinearColor& Color, float Thickness = 0.f);
+	void AddSphere(const FVector& Center, float Radius, int32 Segments, const FLinearColor& Color, float Thickness = 0.f);
+	void AddArrow(const FVector& Start, const FVector& End, float ArrowSize, const FLinearColor& Color, float Thickness = 0.f);
+	//Strings can't be batched, they only share the filter evaluation
+	void AddString(const FVector& TextLocation, const FString& Text, AActor* TestBaseActor, const FLinearColor& Color, float Duration = 0.f);
+
+	void Submit();
+
+	//Batch of the tag for the current frame, submitted after the world ticked its actors
+	static FDebugDrawBatch& GetFrameBatch(const UObject* WorldContextObject, FGameplayTag DebugTag);
+	static void SubmitFrameBatches(const UWorld* World);
+
+private:
+
+	void RefreshFilter();
+
+	TWeakObjectPtr<UWorld> World;
+	FGameplayTag DebugTag;
+	bool bEnabled = false;
+	float Duration = 0.f;
+	uint64 FilterFrame = 0;
+
+	//Kept allocated between frames
+	TArray<FBatchedLine> Lines;
+};
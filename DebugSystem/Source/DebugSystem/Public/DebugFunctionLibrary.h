@@ -1,21 +1,46 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "DebugCounters.h"
+#include "DebugRingBuffer.h"
 #include "DebugSettings.h"
+#include "DebugTiming.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "DebugFunctionLibrary.generated.h"
 
 #define SHOULD_DEBUG(Tag, DebugType) \
 (UDebugFunctionLibrary::ShouldDebug(Tag, DebugType))
 
+//Also counts the message and applies the rate limit of the tag
+#define SHOULD_EMIT_DEBUG(Tag, DebugType) \
+(UDebugFunctionLibrary::ShouldEmitDebug(Tag, DebugType))
+
+//Same, with the counters of the tag cached in a static of the call site
+#define SHOULD_EMIT_DEBUG_AT_SITE(Tag, DebugType) \
+([&]() { static FDebugCounterSite DebugCounterSite; return UDebugFunctionLibrary::ShouldEmitDebug(Tag, DebugType, DebugCounterSite); }())
+
+//Also records the message in the debug ring buffer, messages that are not shown only if the settings opt in.
+//Text is not evaluated when the message is neither shown nor recorded
 #define DEBUG_LOG(LogType, LogCategory, Text, DebugTag) \
-if (SHOULD_DEBUG(DebugTag, EDebugDisplayType::Log))    \
 {                                               \
-	UE_LOG(LogType, LogCategory, TEXT("[%s]%s %s"), *DebugTag.GetTag().ToString(), *UDebugFunctionLibrary::GetAdditivePIEText(), *FString(Text)); \
+	const bool bEmitDebugLog = SHOULD_EMIT_DEBUG_AT_SITE(DebugTag, EDebugDisplayType::Log); \
+	const bool bRecordDebugLog = FDebugRingBuffer::Get().ShouldRecord(bEmitDebugLog); \
+	if (bEmitDebugLog || bRecordDebugLog)       \
+	{                                           \
+		const FString DebugLogText(Text);       \
+		if (bRecordDebugLog)                    \
+		{                                       \
+			FDebugRingBuffer::Get().Record(DebugTag, ELogVerbosity::LogCategory, *DebugLogText); \
+		}                                       \
+		if (bEmitDebugLog)                      \
+		{                                       \
+			UE_LOG(LogType, LogCategory, TEXT("[%s]%s %s"), *DebugTag.GetTag().ToString(), *UDebugFunctionLibrary::GetAdditivePIEText(), *DebugLogText); \
+		}                                       \
+	}                                           \
 }
 
 #define DEBUG_PRINT_TO_SCREEN(Key, Color, Text, DebugTag)               \
-if (SHOULD_DEBUG(DebugTag, EDebugDisplayType::Print))                                    \
+if (SHOULD_EMIT_DEBUG_AT_SITE(DebugTag, EDebugDisplayType::Print))                       \
 {                                                                                 \
 	if (GEngine)                                                                  \
 	{                                                                             \
@@ -38,6 +63,18 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	static bool ShouldDebug(FGameplayTag DebugTag, EDebugDisplayType DebugType);
 
+	static bool ShouldEmitDebug(FGameplayTag DebugTag, EDebugDisplayType DebugType);
+	static bool ShouldEmitDebug(FGameplayTag DebugTag, EDebugDisplayType DebugType, FDebugCounterSite& Site);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Development")
+	static FDebugTagCounters GetDebugCounters(FGameplayTag DebugTag);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Development")
+	static TMap<FGameplayTag, FDebugTagCounters> GetAllDebugCounters();
+
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category="Development")
+	static FDebugTimingStats GetDebugTimingStats(FGameplayTag DebugTag);
+
 	UFUNCTION(BlueprintCallable, BlueprintPure)
 	static float GetDebugDuration(FGameplayTag DebugTag, EDebugDisplayType DebugType);
 
@@ -93,6 +130,41 @@ public:
 		FLinearColor TextColor = FLinearColor::White,
 		float Duration = 0.f);
 	
+	//Batched variants - collected per tag and submitted once per frame, the filter is evaluated once per batch
+	UFUNCTION(BlueprintCallable, Category="Debug|Rendering", meta=(WorldContext="WorldContextObject", DevelopmentOnly))
+	static void BatchedDebugDrawSphere(
+		const UObject* WorldContextObject,
+		const FGameplayTag DebugTag,
+		const FVector Center,
+		float Radius = 100.f,
+		int32 Segments = 12,
+		FLinearColor LineColor = FLinearColor::White,
+		float Thickness = 0.f);
+
+	UFUNCTION(BlueprintCallable, Category="Debug|Rendering", meta=(WorldContext="WorldContextObject", DevelopmentOnly))
+	static void BatchedDebugDrawArrow(
+		const UObject* WorldContextObject,
+		const FGameplayTag DebugTag,
+		const FVector Start,
+		const FVector End,
+		int32 Segments = 12,
+		FLinearColor LineColor = FLinearColor::White,
+		float Thickness = 0.f);
+
+	UFUNCTION(BlueprintCallable, Category="Debug|Rendering", meta=(WorldContext="WorldContextObject", DevelopmentOnly))
+	static void BatchedDebugDrawString(
+		const UObject* WorldContextObject,
+		const FGameplayTag DebugTag,
+		const FVector TextLocation,
+		const FString& Text,
+		AActor* TestBaseActor = nullptr,
+		FLinearColor TextColor = FLinearColor::White,
+		float Duration = 0.f);
+
+	//Writes the last debug messages to the file, or to the log directory if FilePath is empty
+	UFUNCTION(BlueprintCallable, meta = (DevelopmentOnly), Category="Development")
+	static bool DumpDebugRingBuffer(const FString& FilePath);
+
 	static FString GetAdditivePIEText();
 	
 };
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include <atomic>
+
+/**
+ * Keeps the last debug messages in memory, independent of the log and screen output.
+ * Recording is lock free, safe from any thread and does not allocate once the buffer is created.
+ * Messages that are not shown are only recorded if UDebugSettings opts in, formatting them has a cost at every call site.
+ */
+class DEBUGSYSTEM_API FDebugRingBuffer
+{
+public:
+
+	//Longer messages are truncated
+	static constexpr int32 MaxMessageLength = 256;
+
+	//Created on first use with the capacity from UDebugSettings
+	static FDebugRingBuffer& Get();
+
+	explicit FDebugRingBuffer(int32 InCapacity, bool bInRecordSuppressed = false);
+
+	bool IsEnabled() const { return Capacity > 0; }
+	//Whether a message should be recorded, depending on whether it was shown
+	bool ShouldRecord(const bool bEmitted) const { return Capacity > 0 && (bEmitted || bRecordSuppressed); }
+	int32 GetCapacity() const { return Capacity; }
+
+	void Record(FGameplayTag DebugTag, ELogVerbosity::Type Verbosity, const TCHAR* Text);
+
+	//Writes the buffered messages from oldest to newest, messages written during the dump may be skipped
+	bool DumpToFile(const FString& FilePath) const;
+	static FString GetDefaultDumpPath();
+
+private:
+
+	struct FSlot
+	{
+		//Odd while the slot is written, 2 * (Index + 1) once message Index is complete
+		std::atomic<uint64> Sequence { 0 };
+		FGameplayTag DebugTag;
+		ELogVerbosity::Type Verbosity = ELogVerbosity::Log;
+		int64 TimeTicks = 0;
+		TCHAR Text[MaxMessageLength];
+	};
+
+	int32 Capacity = 0;
+	bool bRecordSuppressed = false;
+	TUniquePtr<FSlot[]> Slots;
+	std::atomic<uint64> WriteIndex { 0 };
+};
@@ -30,10 +30,29 @@ public:
 
 	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (DevelopmentOnly))
 	bool SuppressAllDebugs() const;
+
+	//0 means the tag is not rate limited
+	UFUNCTION(BlueprintCallable, BlueprintPure, meta = (DevelopmentOnly))
+	int32 GetMaxMessagesPerSecond(FGameplayTag DebugTag) const;
+
+	int32 GetRingBufferCapacity() const { return RingBufferCapacity; }
+	bool ShouldDumpRingBufferOnCrash() const { return bDumpRingBufferOnCrash; }
+	bool ShouldRingBufferRecordSuppressed() const { return bRingBufferRecordsSuppressed; }
 	
 	static UDebugSettings* Get();
 
+	//Increased whenever the filters or rate limits may have changed, cached filter results compare against it.
+	//Code that changes the settings at runtime has to call MarkFiltersChanged.
+	static uint32 GetFilterVersion();
+	static void MarkFiltersChanged();
+
 	virtual FName GetCategoryName() const override;
+
+	virtual void PostInitProperties() override;
+	virtual void PostReloadConfig(FProperty* PropertyThatWasLoaded) override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
 	
 private:
 	
@@ -69,5 +88,23 @@ protected:
 	UPROPERTY(Config, EditAnywhere, Category = "Debug Settings", meta = (ForceInlineRow))
 	TMap<FGameplayTag, FDebugConfig> SuppressedDebugConfigs;
 
+	//Rate Limiting - messages over the limit are collapsed into one "xN" summary per second, 0 disables the limit
+	UPROPERTY(Config, EditAnywhere, Category = "Debug Settings|RateLimit", meta = (ClampMin = 0))
+	int32 DefaultMaxMessagesPerSecond = 0;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Debug Settings|RateLimit", meta = (ForceInlineRow, ClampMin = 0))
+	TMap<FGameplayTag, int32> MaxMessagesPerSecond;
+
+	//Ring Buffer - last debug messages kept in memory whether they are shown or not, 0 disables it. Read once on first use
+	UPROPERTY(Config, EditAnywhere, Category = "Debug Settings|RingBuffer", meta = (ClampMin = 0))
+	int32 RingBufferCapacity = 4096;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Debug Settings|RingBuffer")
+	bool bDumpRingBufferOnCrash = true;
+
+	//Also records messages of disabled or rate limited tags. DEBUG_LOG then formats every message, even those that are not shown
+	UPROPERTY(Config, EditAnywhere, Category = "Debug Settings|RingBuffer")
+	bool bRingBufferRecordsSuppressed = false;
+
 
 };
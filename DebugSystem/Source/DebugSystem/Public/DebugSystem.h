@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "Containers/Ticker.h"
 #include "Modules/ModuleManager.h"
 
 class FDebugSystemModule : public IModuleInterface
@@ -10,4 +11,10 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+
+	FTSTicker::FDelegateHandle RepeatSummaryTickerHandle;
+	FDelegateHandle SystemErrorHandle;
+	FDelegateHandle WorldPostActorTickHandle;
 };
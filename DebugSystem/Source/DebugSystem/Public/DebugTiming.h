@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include <atomic>
+#include "DebugTiming.generated.h"
+
+USTRUCT(BlueprintType)
+struct DEBUGSYSTEM_API FDebugTimingStats
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Debug")
+	int64 Count = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "Debug")
+	double TotalMs = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "Debug")
+	double MinMs = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "Debug")
+	double MaxMs = 0;
+};
+
+/**
+ * One per DEBUG_SCOPE_TIMER call site. Caches whether the tag passes the debug settings filters
+ * and accumulates the timings without locking.
+ */
+class DEBUGSYSTEM_API FDebugTimingSite
+{
+public:
+
+	explicit FDebugTimingSite(FGameplayTag InDebugTag);
+
+	bool IsEnabled()
+	{
+		const uint32 SettingsVersion = GetSettingsVersion();
+		if (CachedSettingsVersion.load(std::memory_order_relaxed) != SettingsVersion)
+			RefreshEnabled(SettingsVersion);
+		return bEnabled.load(std::memory_order_relaxed);
+	}
+
+	void AddSample(uint64 Cycles);
+	void Reset();
+
+	FGameplayTag GetDebugTag() const { return DebugTag; }
+	void AppendStats(FDebugTimingStats& Stats) const;
+
+	//Summed over every site with the tag
+	static FDebugTimingStats GetStats(FGameplayTag DebugTag);
+	static TMap<FGameplayTag, FDebugTimingStats> GetAllStats();
+	static void ResetAllStats();
+	static void DumpToLog();
+
+private:
+
+	//UDebugSettings::GetFilterVersion, every site evaluates its filter again when it changes
+	static uint32 GetSettingsVersion();
+	void RefreshEnabled(uint32 SettingsVersion);
+
+	const FGameplayTag DebugTag;
+	std::atomic<uint32> CachedSettingsVersion { MAX_uint32 };
+	std::atomic<bool> bEnabled { false };
+
+	std::atomic<uint64> Count { 0 };
+	std::atomic<uint64> TotalCycles { 0 };
+	std::atomic<uint64> MinCycles { MAX_uint64 };
+	std::atomic<uint64> MaxCycles { 0 };
+};
+
+class FDebugTimingScope
+{
+public:
+
+	explicit FDebugTimingScope(FDebugTimingSite& InSite)
+		: Site(InSite.IsEnabled() ? &InSite : nullptr)
+		, StartCycles(Site ? FPlatformTime::Cycles64() : 0)
+	{
+	}
+
+	~FDebugTimingScope()
+	{
+		if (Site)
+			Site->AddSample(FPlatformTime::Cycles64() - StartCycles);
+	}
+
+	UE_NONCOPYABLE(FDebugTimingScope);
+
+private:
+
+	FDebugTimingSite* Site;
+	uint64 StartCycles;
+};
+
+//Times the rest of the scope under the tag, the tag must be the same on every call of the call site.
+//Uses the Log filters of the debug settings, compiled out in shipping builds
+#if !UE_BUILD_SHIPPING
+#define DEBUG_SCOPE_TIMER(DebugTag) \
+	static FDebugTimingSite PREPROCESSOR_JOIN(DebugTimingSite_, __LINE__)(DebugTag); \
+	const FDebugTimingScope PREPROCESSOR_JOIN(DebugTimingScope_, __LINE__)(PREPROCESSOR_JOIN(DebugTimingSite_, __LINE__));
+#else
+#define DEBUG_SCOPE_TIMER(DebugTag)
+#endif
@@ -2,19 +2,62 @@
 
 #include "GameFramework/GameStateBase.h"
 #include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
 #include "GameFramework/Actor.h"
 #include "Kismet/GameplayStatics.h"
+#include "Net/UnrealNetwork.h"
 #include "ReplicatedObject/GlobalReplicatorProxy.h"
+#include "ReplicatedObject/ReplicationRelevancyInterface.h"
 #include "Save/PropertyPackingLibrary.h"
 
 DEFINE_LOG_CATEGORY(LogGlobalReplicator)
 
+bool FReplicatedKey::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+	//Interned keys only send their ID, the name is resolved through the replicated key table
+	uint8 bHasKeyID = HasKeyID() ? 1 : 0;
+	Ar.SerializeBits(&bHasKeyID, 1);
+	
+	if (bHasKeyID)
+	{
+		uint32 PackedKeyID = Ar.IsSaving() ? static_cast<uint32>(KeyID) : 0;
+		Ar.SerializeIntPacked(PackedKeyID);
+		if (Ar.IsLoading())
+		{
+			KeyID = static_cast<int32>(PackedKeyID);
+			ReplicationKey = NAME_None;
+		}
+	}
+	else
+	{
+		Ar << ReplicationKey;
+		if (Ar.IsLoading())
+		{
+			KeyID = INDEX_NONE;
+		}
+	}
+	
+	Ar << TimeStamp;
+
+	bOutSuccess = !Ar.IsError();
+	return true;
+}
+
 UGlobalReplicator::UGlobalReplicator()
 {
 	PrimaryComponentTick.bCanEverTick = true;
 	SetIsReplicatedByDefault(true);
 }
 
+void UGlobalReplicator::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UGlobalReplicator, InternedKeys);
+}
+
 void UGlobalReplicator::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 #if WITH_EDITOR
@@ -22,6 +65,16 @@ void UGlobalReplicator::TickComponent(float DeltaTime, ELevelTick TickType, FAct
 #endif
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	if (GetOwner()->HasAuthority())
+	{
+		RefreshRelevancy();
+		ReleaseUnreferencedKeys();
+	}
+	else
+	{
+		PrunePendingKeyMessages();
+	}
+
 	bool bRegisteredChange = false;
 	for (auto& Pair : ReplicatedDataMap)
 	{
@@ -31,7 +84,7 @@ void UGlobalReplicator::TickComponent(float DeltaTime, ELevelTick TickType, FAct
 		if (Data.ValuePtr)
 		{
 			TArray<uint8> CurrentBytes;
-			PackCurrentValue(Data.ValuePtr, Data.DataType, CurrentBytes);
+			PackCurrentValue(Data.ValuePtr, Data.DataType, Data.Encoding, CurrentBytes);
 
 			//Continue if no changes
 			if (CurrentBytes == Data.LastSentBytes)
@@ -49,10 +102,16 @@ void UGlobalReplicator::TickComponent(float DeltaTime, ELevelTick TickType, FAct
 			Data.LastChangeTimestamp = GetCurrentTimeStamp();
 
 			//Debug: Value Changes
-			FString OldValueString = GetValueString(Data.DataType, Data.LastSentBytes);
+			FString OldValueString = GetValueString(Data.DataType, Data.Encoding, Data.LastSentBytes);
 			FString NewValueString = GetValueString(Data.DataType, Data.ValuePtr);
 			UE_LOG(LogGlobalReplicator, Log, TEXT("Data changed for key: %s. OldValue: %s, NewValue: %s. Executing callbacks."), *Key.ToString(), *OldValueString, *NewValueString);
 
+			//Delta payloads are made against the bytes every remote last received
+			TArray<uint8> Payload;
+			const bool bAuthority = GetOwner()->HasAuthority();
+			if (bAuthority)
+				EncodeForMulticast(Data, CurrentBytes, Payload);
+
 			//Set Data and Execute Callbacks
 			bRegisteredChange = true;
 			Data.LastSentBytes = CurrentBytes;
@@ -62,11 +121,11 @@ void UGlobalReplicator::TickComponent(float DeltaTime, ELevelTick TickType, FAct
 					CallBackPair.Callback(CurrentBytes);
 			}
 
-			FReplicatedKey CurrentKey = FReplicatedKey(Key, GetCurrentTimeStamp());
+			FReplicatedKey CurrentKey = MakeReplicatedKey(Key, GetCurrentTimeStamp());
 			//RPCs
-			if (GetOwner()->HasAuthority())
+			if (bAuthority)
 			{
-				Multicast_UpdateData(CurrentKey, CurrentBytes, false);
+				SendUpdate(Key, CurrentKey, Payload, false, CurrentBytes);
 			}
 			else
 			{
@@ -149,62 +208,50 @@ UGlobalReplicator* UGlobalReplicator::Get(UObject* WorldContext)
 
 void UGlobalReplicator::ReplicateFloat(FName ReplicationKey, float& InValue, const FOnReplicatedValueChanged& OnChanged, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
 {
-	auto CallbackWrapper = [OnChanged](const TArray<uint8>& Data)
+	Replicate<float>(ReplicationKey, InValue, [OnChanged](const float&)
 	{
 		OnChanged.ExecuteIfBound();
-	};
-
-	InternalReplicate(ReplicationKey, static_cast<void*>(&InValue), EReplicatedValueType::Float, CallbackWrapper, bLocalCallOnChange, AccessType, bGetValueFromServer);
+	}, bLocalCallOnChange, AccessType, bGetValueFromServer);
 }
 
 void UGlobalReplicator::ReplicateBool(FName ReplicationKey, bool& InValue, const FOnReplicatedValueChanged& OnChanged, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
 {
-	auto CallbackWrapper = [OnChanged](const TArray<uint8>& Data)
+	Replicate<bool>(ReplicationKey, InValue, [OnChanged](const bool&)
 	{
 		OnChanged.ExecuteIfBound();
-	};
-
-	InternalReplicate(ReplicationKey, static_cast<void*>(&InValue), EReplicatedValueType::Bool, CallbackWrapper, bLocalCallOnChange, AccessType, bGetValueFromServer);
+	}, bLocalCallOnChange, AccessType, bGetValueFromServer);
 }
 
 void UGlobalReplicator::ReplicateInt(FName ReplicationKey, int& InValue, const FOnReplicatedValueChanged& OnChanged, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
 {
-	auto CallbackWrapper = [OnChanged](const TArray<uint8>& Data)
+	Replicate<int32>(ReplicationKey, InValue, [OnChanged](const int32&)
 	{
 		OnChanged.ExecuteIfBound();
-	};
-
-	InternalReplicate(ReplicationKey, static_cast<void*>(&InValue), EReplicatedValueType::Int, CallbackWrapper, bLocalCallOnChange, AccessType, bGetValueFromServer);
+	}, bLocalCallOnChange, AccessType, bGetValueFromServer);
 }
 
 void UGlobalReplicator::ReplicateByteArray(FName ReplicationKey, TArray<uint8>& InValue, const FOnReplicatedValueChanged& OnChanged, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
 {
-	auto CallbackWrapper = [OnChanged](const TArray<uint8>& Data)
+	Replicate<TArray<uint8>>(ReplicationKey, InValue, [OnChanged](const TArray<uint8>&)
 	{
 		OnChanged.ExecuteIfBound();
-	};
-
-	InternalReplicate(ReplicationKey, static_cast<void*>(&InValue), EReplicatedValueType::ByteArray, CallbackWrapper, bLocalCallOnChange, AccessType, bGetValueFromServer);
+	}, bLocalCallOnChange, AccessType, bGetValueFromServer);
 }
 
 void UGlobalReplicator::ReplicateString(FName ReplicationKey, FString& InValue, const FOnReplicatedValueChanged& OnChanged, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
 {
-	auto CallbackWrapper = [OnChanged](const TArray<uint8>& Data)
+	Replicate<FString>(ReplicationKey, InValue, [OnChanged](const FString&)
 	{
 		OnChanged.ExecuteIfBound();
-	};
-
-	InternalReplicate(ReplicationKey, static_cast<void*>(&InValue), EReplicatedValueType::String, CallbackWrapper, bLocalCallOnChange, AccessType, bGetValueFromServer);
+	}, bLocalCallOnChange, AccessType, bGetValueFromServer);
 }
 
 void UGlobalReplicator::ReplicateVector(FName ReplicationKey, FVector& InValue, const FOnReplicatedValueChanged& OnChanged, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
 {
-	auto CallbackWrapper = [OnChanged](const TArray<uint8>& Data)
+	Replicate<FVector>(ReplicationKey, InValue, [OnChanged](const FVector&)
 	{
 		OnChanged.ExecuteIfBound();
-	};
-
-	InternalReplicate(ReplicationKey, static_cast<void*>(&InValue), EReplicatedValueType::Vector, CallbackWrapper, bLocalCallOnChange, AccessType, bGetValueFromServer);
+	}, bLocalCallOnChange, AccessType, bGetValueFromServer);
 }
 
 bool UGlobalReplicator::DereplicateData(FName ReplicationKey, bool bPropagateToRemote)
@@ -228,7 +275,7 @@ bool UGlobalReplicator::DereplicateData(FName ReplicationKey, bool bPropagateToR
 	{
 		if (GetOwner()->HasAuthority())
 		{
-			Multicast_DereplicateData(ReplicationKey);
+			Multicast_DereplicateData(MakeReplicatedKey(ReplicationKey, GetCurrentTimeStamp()));
 		}
 		else
 		{
@@ -247,76 +294,231 @@ bool UGlobalReplicator::DereplicateData(FName ReplicationKey, bool bPropagateToR
 	return bSuccess;
 }
 
+bool UGlobalReplicator::SetReplicationEncoding(FName ReplicationKey, FPackingEncoding Encoding)
+{
+	FLocalData* Data = ReplicatedDataMap.Find(ReplicationKey);
+	if (!Data)
+	{
+		PendingEncodings.Add(ReplicationKey, Encoding);
+		return true;
+	}
+
+	if (!IsEncodingSupported(Data->DataType, Encoding))
+	{
+		UE_LOG(LogGlobalReplicator, Warning, TEXT("SetReplicationEncoding: Encoding %s is not supported for the data type of key: %s"), *UEnum::GetValueAsString(Encoding.EncodingType), *ReplicationKey.ToString());
+		return false;
+	}
+	
+	//Re-encode the last sent value so change detection keeps comparing like with like,
+	//without losing a local change that has not been sent yet
+	FLocalData CurrentValue = *Data;
+	CurrentValue.Encoding = FPackingEncoding();
+	PackCurrentValue(Data->ValuePtr, Data->DataType, CurrentValue.Encoding, CurrentValue.LastSentBytes);
+	
+	ApplyLastSentData(*Data);
+	Data->Encoding = Encoding;
+	PackCurrentValue(Data->ValuePtr, Data->DataType, Data->Encoding, Data->LastSentBytes);
+	ApplyLastSentData(CurrentValue);
+	return true;
+}
+
+void UGlobalReplicator::SetReplicationRelevancy(FName ReplicationKey, FGameplayTag RelevancyTag)
+{
+	if (!GetOwner()->HasAuthority())
+		return;
+	
+	FGameplayTag PreviousTag;
+	if (KeyRelevancyTags.RemoveAndCopyValue(ReplicationKey, PreviousTag))
+	{
+		TArray<FName>& PreviousKeys = ScopedKeysByTag.FindChecked(PreviousTag);
+		PreviousKeys.Remove(ReplicationKey);
+		if (PreviousKeys.IsEmpty())
+			ScopedKeysByTag.Remove(PreviousTag);
+	}
+	
+	if (RelevancyTag.IsValid())
+	{
+		KeyRelevancyTags.Add(ReplicationKey, RelevancyTag);
+
+		//A new tag has to be evaluated for every connection
+		TArray<FName>& ScopedKeys = ScopedKeysByTag.FindOrAdd(RelevancyTag);
+		if (ScopedKeys.IsEmpty())
+			bAllRelevancyDirty = true;
+		ScopedKeys.Add(ReplicationKey);
+		return;
+	}
+
+	if (!PreviousTag.IsValid())
+		return;
+
+	//Connections outside the scope may have missed updates, bring everyone up to date
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController && !PlayerController->IsLocalController())
+			SendFullValue(PlayerController, ReplicationKey, false);
+	}
+	RelayedScopedValues.Remove(ReplicationKey);
+}
+
 void UGlobalReplicator::Server_UpdateData(FReplicatedKey ReplicationKey, const TArray<uint8>& NewData, bool OnlyUpdateRequested)
 {
-	Multicast_UpdateData(ReplicationKey, NewData, OnlyUpdateRequested);
+	const FName Key = ResolveReplicatedKey(ReplicationKey);
+	if (Key.IsNone())
+	{
+		UE_LOG(LogGlobalReplicator, Warning, TEXT("Server_UpdateData: Could not resolve key ID: %d"), ReplicationKey.KeyID);
+		return;
+	}
+	
+	//Clients always forward full values, the server encodes against its own last sent bytes
+	TArray<uint8> Payload;
+	if (!OnlyUpdateRequested && ReplicatedDataMap.Contains(Key))
+		EncodeForMulticast(ReplicatedDataMap[Key], NewData, Payload);
+	else
+		Payload = NewData;
+	
+	SendUpdate(Key, MakeReplicatedKey(Key, ReplicationKey.TimeStamp), Payload, OnlyUpdateRequested, NewData);
 }
 
-void UGlobalReplicator::Server_RequestData(FName ReplicationKey)
+void UGlobalReplicator::Server_RequestData(FName ReplicationKey, APlayerController* Requester)
 {
+	//Scoped keys only answer the connection that asked
+	if (Requester && !Requester->IsLocalController() && KeyRelevancyTags.Contains(ReplicationKey))
+	{
+		SendFullValue(Requester, ReplicationKey, true);
+		return;
+	}
+	
 	if (ReplicatedDataMap.Contains(ReplicationKey))
 	{
 		FLocalData& Data = ReplicatedDataMap[ReplicationKey];
-		FReplicatedKey ReplicatedKey = FReplicatedKey(ReplicationKey, Data.LastChangeTimestamp);
+		FReplicatedKey ReplicatedKey = MakeReplicatedKey(ReplicationKey, Data.LastChangeTimestamp);
 		Multicast_UpdateData(ReplicatedKey, Data.LastSentBytes, true);
 	}
 }
 
 void UGlobalReplicator::Server_DereplicateData(FName ReplicationKey)
 {
-	Multicast_DereplicateData(ReplicationKey);
+	Multicast_DereplicateData(MakeReplicatedKey(ReplicationKey, GetCurrentTimeStamp()));
 }
 
 void UGlobalReplicator::Multicast_UpdateData_Implementation(FReplicatedKey ReplicationKey, const TArray<uint8>& NewData, bool OnlyUpdateRequested)
 {
-	if (ReplicatedDataMap.Contains(ReplicationKey.ReplicationKey))
+	ReceiveUpdate(ReplicationKey, NewData, OnlyUpdateRequested, OnlyUpdateRequested);
+}
+
+void UGlobalReplicator::ReceiveUpdate(const FReplicatedKey& ReplicationKey, const TArray<uint8>& NewData, bool OnlyUpdateRequested, bool bFullValue)
+{
+	const FName Key = ResolveReplicatedKey(ReplicationKey);
+	if (Key.IsNone() && ReplicationKey.HasKeyID())
+	{
+		//The interned key table has not arrived for this ID yet, retry once it has
+		FPendingKeyMessage PendingMessage;
+		PendingMessage.ReplicationKey = ReplicationKey;
+		PendingMessage.Data = NewData;
+		PendingMessage.bOnlyUpdateRequested = OnlyUpdateRequested;
+		PendingMessage.bFullValue = bFullValue;
+		QueuePendingKeyMessage(MoveTemp(PendingMessage));
+		UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: Deferring update for unresolved key ID: %d"), ReplicationKey.KeyID);
+		return;
+	}
+	
+	if (ReplicatedDataMap.Contains(Key))
 	{
-		FLocalData& Data = ReplicatedDataMap[ReplicationKey.ReplicationKey];
+		FLocalData& Data = ReplicatedDataMap[Key];
 
 		//Return if only update pending data
 		if (OnlyUpdateRequested && !Data.bPendingLocalUpdate)
 		{
-			UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: Returning because only update pending data and no pending update for key: %s"), *ReplicationKey.ReplicationKey.ToString());
+			UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: Returning because only update pending data and no pending update for key: %s"), *Key.ToString());
 			return;
 		}
 
 		//Return if Replicated Data is out of date
 		if (!OnlyUpdateRequested && Data.LastChangeTimestamp >= ReplicationKey.TimeStamp)
 		{
-			UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: Returning because data is out of date for key: %s"), *ReplicationKey.ReplicationKey.ToString());
+			UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: Returning because data is out of date for key: %s"), *Key.ToString());
 			return;
 		}
+
+		//Requested updates and relevancy snapshots always carry the full value
+		TArray<uint8> DecodedData;
+		if (!bFullValue && Data.Encoding.IsDelta())
+		{
+			if (!UPropertyPackingLibrary::ApplyDelta(Data.LastSentBytes, NewData, DecodedData))
+			{
+				UE_LOG(LogGlobalReplicator, Warning, TEXT("OnReceiveData: Delta does not match the last received value for key: %s. Requesting full value."), *Key.ToString());
+				if (UGlobalReplicatorProxy* Proxy = GetOwner()->HasAuthority() ? nullptr : GetClientReplicatorProxy())
+				{
+					Data.bPendingLocalUpdate = true;
+					Proxy->Server_ForwardRequestValue(Key);
+				}
+				return;
+			}
+		}
+		else
+		{
+			DecodedData = NewData;
+		}
 		Data.LastChangeTimestamp = ReplicationKey.TimeStamp;
 		
 		//Return if no change
-		if (!OnlyUpdateRequested && NewData == Data.LastSentBytes)
+		if (!OnlyUpdateRequested && DecodedData == Data.LastSentBytes)
 		{
-			UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: Returning because no change for key: %s"), *ReplicationKey.ReplicationKey.ToString());
+			UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: Returning because no change for key: %s"), *Key.ToString());
 			return;
 		}
 
-		FString NewValueString = GetValueString(Data.DataType, NewData);
+		FString NewValueString = GetValueString(Data.DataType, Data.Encoding, DecodedData);
 		FString OldValueString = GetValueString(Data.DataType, Data.ValuePtr);
-		UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: New data for key: %s. OldValue: %s, NewValue: %s. Executing callbacks."), *ReplicationKey.ReplicationKey.ToString(), *OldValueString, *NewValueString);
+		UE_LOG(LogGlobalReplicator, Log, TEXT("OnReceiveData: New data for key: %s. OldValue: %s, NewValue: %s. Executing callbacks."), *Key.ToString(), *OldValueString, *NewValueString);
 
 		Data.bPendingLocalUpdate = false;
-		Data.LastSentBytes = NewData;
+		Data.LastSentBytes = DecodedData;
 		ApplyLastSentData(Data);
 
 		for (auto& CallBackPair : Data.Callbacks)
 		{
-			CallBackPair.Callback(NewData);
+			CallBackPair.Callback(DecodedData);
 		}
 	}
 	else
 	{
-		UE_LOG(LogGlobalReplicator, Warning, TEXT("OnReceiveData: No ReplicationData found for key: %s"), *ReplicationKey.ReplicationKey.ToString());
+		UE_LOG(LogGlobalReplicator, Warning, TEXT("OnReceiveData: No ReplicationData found for key: %s"), *Key.ToString());
 	}
 }
 
-void UGlobalReplicator::Multicast_DereplicateData_Implementation(FName ReplicationKey)
+void UGlobalReplicator::Multicast_DereplicateData_Implementation(FReplicatedKey ReplicationKey)
 {
-	DeleteData(ReplicationKey);
+	const FName Key = ResolveReplicatedKey(ReplicationKey);
+	if (Key.IsNone() && ReplicationKey.HasKeyID())
+	{
+		FPendingKeyMessage PendingMessage;
+		PendingMessage.ReplicationKey = ReplicationKey;
+		PendingMessage.bDereplicate = true;
+		QueuePendingKeyMessage(MoveTemp(PendingMessage));
+		return;
+	}
+	
+	DeleteData(Key);
+	if (GetOwner()->HasAuthority())
+	{
+		RelayedScopedValues.Remove(Key);
+		ScheduleKeyRelease(Key);
+	}
+}
+
+void UGlobalReplicator::OnRep_InternedKeys()
+{
+	//Released IDs are cleared and reused in place, so the lookup is rebuilt
+	InternedKeyIDs.Reset();
+	for (int32 KeyID = 0; KeyID < InternedKeys.Num(); ++KeyID)
+	{
+		if (!InternedKeys[KeyID].IsNone())
+			InternedKeyIDs.Add(InternedKeys[KeyID], KeyID);
+	}
+
+	FlushPendingKeyMessages();
 }
 
 UGlobalReplicatorProxy* UGlobalReplicator::GetClientReplicatorProxy() const
@@ -341,11 +543,17 @@ uint32 UGlobalReplicator::GetCurrentTimeStamp() const
 	return static_cast<uint32>(GameState->GetServerWorldTimeSeconds() * 1000);
 }
 
-void UGlobalReplicator::InternalReplicate(FName ReplicationKey, void* ValuePtr, EReplicatedValueType DataType, TFunction<void(const TArray<uint8>&)> Callback, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
+bool UGlobalReplicator::InternalReplicate(FName ReplicationKey, void* ValuePtr, EReplicatedValueType DataType, TFunction<void(const TArray<uint8>&)> Callback, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
 {
 	FLocalData::FCallBackPair CallbackPair(Callback, bLocalCallOnChange);
 	if (ReplicatedDataMap.Contains(ReplicationKey))
 	{
+		if (ReplicatedDataMap[ReplicationKey].DataType != DataType)
+		{
+			UE_LOG(LogGlobalReplicator, Warning, TEXT("InternalReplicate: Key %s is already replicated as %s, not as %s."), *ReplicationKey.ToString(), *UEnum::GetValueAsString(ReplicatedDataMap[ReplicationKey].DataType), *UEnum::GetValueAsString(DataType));
+			return false;
+		}
+		
 		ReplicatedDataMap[ReplicationKey].Callbacks.Add(CallbackPair);
 		if (bLocalCallOnChange)
 			Callback(ReplicatedDataMap[ReplicationKey].LastSentBytes);
@@ -356,20 +564,29 @@ void UGlobalReplicator::InternalReplicate(FName ReplicationKey, void* ValuePtr,
 		NewData.ValuePtr = ValuePtr;
 		NewData.DataType = DataType;
 		NewData.AccessType = AccessType;
+		if (PendingEncodings.RemoveAndCopyValue(ReplicationKey, NewData.Encoding) && !IsEncodingSupported(DataType, NewData.Encoding))
+		{
+			UE_LOG(LogGlobalReplicator, Warning, TEXT("InternalReplicate: Encoding %s is not supported for the data type of key: %s. Using raw encoding."), *UEnum::GetValueAsString(NewData.Encoding.EncodingType), *ReplicationKey.ToString());
+			NewData.Encoding = FPackingEncoding();
+		}
 		
 		//Initialize LastSentBytes with the current value.
-		PackCurrentValue(ValuePtr, DataType, NewData.LastSentBytes);
+		PackCurrentValue(ValuePtr, DataType, NewData.Encoding, NewData.LastSentBytes);
 		
 		NewData.Callbacks.Add(CallbackPair);
 		ReplicatedDataMap.Add(ReplicationKey, NewData);
 
+		//Intern on registration so clients usually have the ID before the first update
+		if (GetOwner()->HasAuthority())
+			InternKey(ReplicationKey);
+
 		if (bGetValueFromServer && !GetOwner()->HasAuthority())
 		{
 			UGlobalReplicatorProxy* Proxy = GetClientReplicatorProxy();
 			if (!Proxy)
 			{
 				UE_LOG(LogGlobalReplicator, Error, TEXT("No Client Replicator Proxy Found!!!"));
-				return;
+				return true;
 			}
 			
 			ReplicatedDataMap[ReplicationKey].bPendingLocalUpdate = bGetValueFromServer;
@@ -381,16 +598,379 @@ void UGlobalReplicator::InternalReplicate(FName ReplicationKey, void* ValuePtr,
 				Callback(NewData.LastSentBytes);
 		}
 	}
+	return true;
+}
+
+int32 UGlobalReplicator::InternKey(FName ReplicationKey)
+{
+	if (const int32* ExistingKeyID = InternedKeyIDs.Find(ReplicationKey))
+	{
+		return *ExistingKeyID;
+	}
+
+	int32 NewKeyID;
+	if (!FreeKeyIDs.IsEmpty() && FPlatformTime::Seconds() - FreeKeyIDs[0].Value >= KeyReleaseDelay)
+	{
+		NewKeyID = FreeKeyIDs[0].Key;
+		FreeKeyIDs.RemoveAt(0);
+		InternedKeys[NewKeyID] = ReplicationKey;
+	}
+	else
+	{
+		NewKeyID = InternedKeys.Add(ReplicationKey);
+	}
+	InternedKeyIDs.Add(ReplicationKey, NewKeyID);
+	PendingKeyReleases.Remove(ReplicationKey);
+	
+	UE_LOG(LogGlobalReplicator, Log, TEXT("InternKey: Assigned ID %d to key: %s"), NewKeyID, *ReplicationKey.ToString());
+	return NewKeyID;
+}
+
+FReplicatedKey UGlobalReplicator::MakeReplicatedKey(FName ReplicationKey, uint32 TimeStamp)
+{
+	if (ReplicationKey.IsNone())
+	{
+		return FReplicatedKey(ReplicationKey, TimeStamp);
+	}
+	
+	if (GetOwner()->HasAuthority())
+	{
+		return FReplicatedKey(ReplicationKey, InternKey(ReplicationKey), TimeStamp);
+	}
+
+	//Clients fall back to sending the name until the server's ID has replicated
+	const int32* KeyID = InternedKeyIDs.Find(ReplicationKey);
+	return FReplicatedKey(ReplicationKey, KeyID ? *KeyID : INDEX_NONE, TimeStamp);
 }
 
-void UGlobalReplicator::PackCurrentValue(void* ValuePtr, EReplicatedValueType DataType, TArray<uint8>& OutBytes) const
+FName UGlobalReplicator::ResolveReplicatedKey(const FReplicatedKey& ReplicationKey) const
+{
+	if (ReplicationKey.HasKeyID() && InternedKeys.IsValidIndex(ReplicationKey.KeyID))
+	{
+		return InternedKeys[ReplicationKey.KeyID];
+	}
+
+	return ReplicationKey.ReplicationKey;
+}
+
+void UGlobalReplicator::QueuePendingKeyMessage(FPendingKeyMessage&& Message)
+{
+	PrunePendingKeyMessages();
+	if (PendingKeyMessages.Num() >= MaxPendingKeyMessages)
+	{
+		UE_LOG(LogGlobalReplicator, Warning, TEXT("QueuePendingKeyMessage: Too many unresolved messages, dropping the oldest for key ID: %d"), PendingKeyMessages[0].ReplicationKey.KeyID);
+		PendingKeyMessages.RemoveAt(0);
+	}
+
+	Message.ReceiveTime = FPlatformTime::Seconds();
+	PendingKeyMessages.Add(MoveTemp(Message));
+}
+
+void UGlobalReplicator::PrunePendingKeyMessages()
+{
+	//Messages are queued in receive order
+	const double CurrentTime = FPlatformTime::Seconds();
+	int32 NumExpired = 0;
+	while (NumExpired < PendingKeyMessages.Num() && CurrentTime - PendingKeyMessages[NumExpired].ReceiveTime > PendingKeyMessageTimeout)
+	{
+		UE_LOG(LogGlobalReplicator, Warning, TEXT("PrunePendingKeyMessages: Dropping message for key ID %d that never resolved."), PendingKeyMessages[NumExpired].ReplicationKey.KeyID);
+		++NumExpired;
+	}
+	
+	if (NumExpired > 0)
+		PendingKeyMessages.RemoveAt(0, NumExpired);
+}
+
+void UGlobalReplicator::FlushPendingKeyMessages()
+{
+	if (PendingKeyMessages.IsEmpty())
+		return;
+
+	//Messages that still cannot be resolved are queued again by the handlers
+	PrunePendingKeyMessages();
+	TArray<FPendingKeyMessage> Messages = MoveTemp(PendingKeyMessages);
+	PendingKeyMessages.Reset();
+	
+	for (FPendingKeyMessage& Message : Messages)
+	{
+		const int32 NumPending = PendingKeyMessages.Num();
+		if (Message.bDereplicate)
+		{
+			Multicast_DereplicateData_Implementation(Message.ReplicationKey);
+		}
+		else
+		{
+			ReceiveUpdate(Message.ReplicationKey, Message.Data, Message.bOnlyUpdateRequested, Message.bFullValue);
+		}
+
+		//Requeued messages keep aging from when they were first received
+		if (PendingKeyMessages.Num() > NumPending)
+			PendingKeyMessages.Last().ReceiveTime = Message.ReceiveTime;
+	}
+}
+
+void UGlobalReplicator::ScheduleKeyRelease(FName ReplicationKey)
+{
+	if (InternedKeyIDs.Contains(ReplicationKey) && !IsKeyReferenced(ReplicationKey))
+		PendingKeyReleases.Add(ReplicationKey, FPlatformTime::Seconds());
+}
+
+void UGlobalReplicator::ReleaseUnreferencedKeys()
+{
+	if (PendingKeyReleases.IsEmpty())
+		return;
+
+	const double CurrentTime = FPlatformTime::Seconds();
+	for (auto It = PendingKeyReleases.CreateIterator(); It; ++It)
+	{
+		if (CurrentTime - It.Value() < KeyReleaseDelay)
+			continue;
+
+		const FName ReplicationKey = It.Key();
+		It.RemoveCurrent();
+
+		//Registered or scoped again since it was scheduled
+		int32 KeyID;
+		if (IsKeyReferenced(ReplicationKey) || !InternedKeyIDs.RemoveAndCopyValue(ReplicationKey, KeyID))
+			continue;
+
+		InternedKeys[KeyID] = NAME_None;
+		FreeKeyIDs.Emplace(KeyID, CurrentTime);
+		UE_LOG(LogGlobalReplicator, Log, TEXT("ReleaseUnreferencedKeys: Released ID %d of key: %s"), KeyID, *ReplicationKey.ToString());
+	}
+}
+
+bool UGlobalReplicator::IsKeyReferenced(FName ReplicationKey) const
+{
+	return ReplicatedDataMap.Contains(ReplicationKey) || KeyRelevancyTags.Contains(ReplicationKey) || RelayedScopedValues.Contains(ReplicationKey);
+}
+
+void UGlobalReplicator::SendUpdate(FName ReplicationKey, const FReplicatedKey& ReplicatedKey, const TArray<uint8>& Payload, bool OnlyUpdateRequested, const TArray<uint8>& FullBytes)
+{
+	const FGameplayTag* RelevancyTag = KeyRelevancyTags.Find(ReplicationKey);
+	if (!RelevancyTag)
+	{
+		Multicast_UpdateData(ReplicatedKey, Payload, OnlyUpdateRequested);
+		return;
+	}
+
+	//Keep the value of keys the server only relays so late relevant connections can catch up
+	if (!ReplicatedDataMap.Contains(ReplicationKey))
+	{
+		FScopedKeyValue& RelayedValue = RelayedScopedValues.FindOrAdd(ReplicationKey);
+		RelayedValue.Bytes = FullBytes;
+		RelayedValue.TimeStamp = ReplicatedKey.TimeStamp;
+	}
+
+	//The server applies the update itself, relevant remote connections receive it through their proxy
+	ReceiveUpdate(ReplicatedKey, Payload, OnlyUpdateRequested, OnlyUpdateRequested);
+	
+	for (const auto& Pair : RelevantTagsByController)
+	{
+		APlayerController* PlayerController = Pair.Key.Get();
+		if (!PlayerController || !Pair.Value.HasTagExact(*RelevancyTag))
+			continue;
+
+		if (UGlobalReplicatorProxy* Proxy = PlayerController->FindComponentByClass<UGlobalReplicatorProxy>())
+			Proxy->Client_ReceiveUpdate(ReplicatedKey, Payload, OnlyUpdateRequested, OnlyUpdateRequested);
+	}
+}
+
+void UGlobalReplicator::SendFullValue(APlayerController* PlayerController, FName ReplicationKey, bool OnlyUpdateRequested)
+{
+	TArray<uint8> Bytes;
+	uint32 TimeStamp = 0;
+	if (!PlayerController || !GetServerValue(ReplicationKey, Bytes, TimeStamp))
+		return;
+
+	UGlobalReplicatorProxy* Proxy = PlayerController->FindComponentByClass<UGlobalReplicatorProxy>();
+	if (!Proxy)
+	{
+		UE_LOG(LogGlobalReplicator, Warning, TEXT("SendFullValue: No Replicator Proxy on %s for key: %s"), *PlayerController->GetName(), *ReplicationKey.ToString());
+		return;
+	}
+	
+	Proxy->Client_ReceiveUpdate(MakeReplicatedKey(ReplicationKey, TimeStamp), Bytes, OnlyUpdateRequested, true);
+}
+
+bool UGlobalReplicator::GetServerValue(FName ReplicationKey, TArray<uint8>& OutBytes, uint32& OutTimeStamp) const
+{
+	if (const FLocalData* Data = ReplicatedDataMap.Find(ReplicationKey))
+	{
+		OutBytes = Data->LastSentBytes;
+		OutTimeStamp = Data->LastChangeTimestamp;
+		return true;
+	}
+	
+	if (const FScopedKeyValue* RelayedValue = RelayedScopedValues.Find(ReplicationKey))
+	{
+		OutBytes = RelayedValue->Bytes;
+		OutTimeStamp = RelayedValue->TimeStamp;
+		return true;
+	}
+	
+	return false;
+}
+
+void UGlobalReplicator::MarkRelevancyDirty(AActor* RelevancyActor)
+{
+	if (!GetOwner()->HasAuthority())
+		return;
+
+	APlayerController* PlayerController = nullptr;
+	if (const APawn* Pawn = Cast<APawn>(RelevancyActor))
+		PlayerController = Pawn->GetController<APlayerController>();
+	else if (const APlayerState* PlayerState = Cast<APlayerState>(RelevancyActor))
+		PlayerController = PlayerState->GetPlayerController();
+
+	if (PlayerController)
+		DirtyRelevancyControllers.Add(PlayerController);
+	else
+		bAllRelevancyDirty = true;
+}
+
+void UGlobalReplicator::RefreshRelevancy()
+{
+	if (ScopedKeysByTag.IsEmpty())
+	{
+		RelevantTagsByController.Reset();
+		RelevancyProvidersByController.Reset();
+		DirtyRelevancyControllers.Reset();
+		bAllRelevancyDirty = false;
+		return;
+	}
+
+	//Connections marked dirty are refreshed right away, all others on the interval
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	const bool bRefreshAll = bAllRelevancyDirty || CurrentTime >= NextRelevancyRefreshTime;
+	if (!bRefreshAll && DirtyRelevancyControllers.IsEmpty())
+		return;
+
+	if (!bRefreshAll)
+	{
+		//Providers may mark themselves dirty again while being asked
+		const TSet<TWeakObjectPtr<APlayerController>> DirtyControllers = MoveTemp(DirtyRelevancyControllers);
+		DirtyRelevancyControllers.Reset();
+		for (const TWeakObjectPtr<APlayerController>& PlayerController : DirtyControllers)
+		{
+			if (PlayerController.IsValid() && !PlayerController->IsLocalController())
+				RefreshControllerRelevancy(PlayerController.Get());
+		}
+		return;
+	}
+
+	bAllRelevancyDirty = false;
+	DirtyRelevancyControllers.Reset();
+	NextRelevancyRefreshTime = CurrentTime + RelevancyRefreshInterval;
+
+	for (auto It = RelevantTagsByController.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+			It.RemoveCurrent();
+	}
+	for (auto It = RelevancyProvidersByController.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+			It.RemoveCurrent();
+	}
+
+	//The server always has every value, only remote connections are filtered
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController* PlayerController = It->Get();
+		if (PlayerController && !PlayerController->IsLocalController())
+			RefreshControllerRelevancy(PlayerController);
+	}
+}
+
+void UGlobalReplicator::RefreshControllerRelevancy(APlayerController* PlayerController)
+{
+	const FRelevancyProviders& Providers = GetRelevancyProviders(PlayerController);
+	FGameplayTagContainer& RelevantTags = RelevantTagsByController.FindOrAdd(PlayerController);
+
+	for (const auto& Pair : ScopedKeysByTag)
+	{
+		const FGameplayTag& ScopedTag = Pair.Key;
+		const bool bRelevant = IsTagRelevantForProviders(Providers, ScopedTag);
+		const bool bWasRelevant = RelevantTags.HasTagExact(ScopedTag);
+		
+		if (bRelevant && !bWasRelevant)
+		{
+			RelevantTags.AddTag(ScopedTag);
+
+			//Catch up on everything scoped to the tag that was missed while not relevant
+			for (const FName& ScopedKey : Pair.Value)
+			{
+				SendFullValue(PlayerController, ScopedKey, false);
+			}
+		}
+		else if (!bRelevant && bWasRelevant)
+		{
+			RelevantTags.RemoveTag(ScopedTag);
+		}
+	}
+
+	//Tags without scoped keys are dropped, so they count as newly relevant if they are scoped again
+	for (const FGameplayTag& RelevantTag : FGameplayTagContainer(RelevantTags))
+	{
+		if (!ScopedKeysByTag.Contains(RelevantTag))
+			RelevantTags.RemoveTag(RelevantTag);
+	}
+}
+
+const UGlobalReplicator::FRelevancyProviders& UGlobalReplicator::GetRelevancyProviders(const APlayerController* PlayerController)
+{
+	FRelevancyProviders& Providers = RelevancyProvidersByController.FindOrAdd(PlayerController);
+	AActor* Pawn = PlayerController->GetPawn();
+	AActor* PlayerState = PlayerController->PlayerState;
+	if (Providers.bCollected && Providers.Pawn.Get() == Pawn && Providers.PlayerState.Get() == PlayerState)
+		return Providers;
+
+	Providers.Pawn = Pawn;
+	Providers.PlayerState = PlayerState;
+	Providers.Objects.Reset();
+	Providers.bCollected = true;
+
+	//Relevancy can be provided by the pawn, the player state or any of their components
+	for (AActor* RelevancyActor : { Pawn, PlayerState })
+	{
+		if (!RelevancyActor)
+			continue;
+		
+		if (RelevancyActor->Implements<UReplicationRelevancy>())
+			Providers.Objects.Add(RelevancyActor);
+
+		RelevancyActor->ForEachComponent(false, [&Providers](UActorComponent* Component)
+		{
+			if (Component->Implements<UReplicationRelevancy>())
+				Providers.Objects.Add(Component);
+		});
+	}
+	return Providers;
+}
+
+bool UGlobalReplicator::IsTagRelevantForProviders(const FRelevancyProviders& Providers, FGameplayTag RelevancyTag)
+{
+	for (const TWeakObjectPtr<UObject>& Provider : Providers.Objects)
+	{
+		if (Provider.IsValid() && IReplicationRelevancy::Execute_IsRelevantForTag(Provider.Get(), RelevancyTag))
+			return true;
+	}
+	
+	return false;
+}
+
+void UGlobalReplicator::PackCurrentValue(void* ValuePtr, EReplicatedValueType DataType, const FPackingEncoding& Encoding, TArray<uint8>& OutBytes) const
 {
 	switch (DataType)
 	{
 	case EReplicatedValueType::Float:
 		{
 			float Value = *static_cast<float*>(ValuePtr);
-			UPropertyPackingLibrary::PackValue<float>(Value, OutBytes);
+			if (Encoding.IsQuantized())
+				UPropertyPackingLibrary::PackQuantizedFloat(Value, Encoding.Precision, OutBytes);
+			else
+				UPropertyPackingLibrary::PackValue<float>(Value, OutBytes);
 			break;
 		}
 	case EReplicatedValueType::Bool:
@@ -414,7 +994,10 @@ void UGlobalReplicator::PackCurrentValue(void* ValuePtr, EReplicatedValueType Da
 	case EReplicatedValueType::Vector:
 		{
 			FVector Value = *static_cast<FVector*>(ValuePtr);
-			UPropertyPackingLibrary::PackValue<FVector>(Value, OutBytes);
+			if (Encoding.IsQuantized())
+				UPropertyPackingLibrary::PackQuantizedVector(Value, Encoding.Precision, OutBytes);
+			else
+				UPropertyPackingLibrary::PackValue<FVector>(Value, OutBytes);
 			break;
 		}
 	case EReplicatedValueType::ByteArray:
@@ -435,7 +1018,10 @@ void UGlobalReplicator::ApplyLastSentData(FLocalData& Data)
 	case EReplicatedValueType::Float:
 		{
 			float NewValue = 0.f;
-			UPropertyPackingLibrary::UnpackValue<float>(Data.LastSentBytes, NewValue);
+			if (Data.Encoding.IsQuantized())
+				UPropertyPackingLibrary::UnpackQuantizedFloat(Data.LastSentBytes, Data.Encoding.Precision, NewValue);
+			else
+				UPropertyPackingLibrary::UnpackValue<float>(Data.LastSentBytes, NewValue);
 			*static_cast<float*>(Data.ValuePtr) = NewValue;
 			break;
 		}
@@ -463,7 +1049,10 @@ void UGlobalReplicator::ApplyLastSentData(FLocalData& Data)
 	case EReplicatedValueType::Vector:
 		{
 			FVector NewValue = FVector();
-			UPropertyPackingLibrary::UnpackValue<FVector>(Data.LastSentBytes, NewValue);
+			if (Data.Encoding.IsQuantized())
+				UPropertyPackingLibrary::UnpackQuantizedVector(Data.LastSentBytes, Data.Encoding.Precision, NewValue);
+			else
+				UPropertyPackingLibrary::UnpackValue<FVector>(Data.LastSentBytes, NewValue);
 			*static_cast<FVector*>(Data.ValuePtr) = NewValue;
 			break;
 		}
@@ -479,6 +1068,27 @@ void UGlobalReplicator::ApplyLastSentData(FLocalData& Data)
 	}
 }
 
+void UGlobalReplicator::EncodeForMulticast(const FLocalData& Data, const TArray<uint8>& NewBytes, TArray<uint8>& OutPayload) const
+{
+	if (Data.Encoding.IsDelta())
+	{
+		UPropertyPackingLibrary::PackDelta(Data.LastSentBytes, NewBytes, OutPayload);
+	}
+	else
+	{
+		OutPayload = NewBytes;
+	}
+}
+
+bool UGlobalReplicator::RemoveCallback(FName ReplicationKey, FDelegateHandle Handle)
+{
+	FLocalData* Data = ReplicatedDataMap.Find(ReplicationKey);
+	if (!Data || !Handle.IsValid())
+		return false;
+
+	return Data->Callbacks.RemoveAll([Handle](const FLocalData::FCallBackPair& CallbackPair) { return CallbackPair.Handle == Handle; }) > 0;
+}
+
 bool UGlobalReplicator::DeleteData(FName ReplicationKey)
 {
 	int32 NumRemoved = ReplicatedDataMap.Remove(ReplicationKey);
@@ -492,14 +1102,30 @@ bool UGlobalReplicator::HasAuthorityToChange(const FLocalData& Data) const
 	return bServer ? Data.AccessType != EReplicationAccessType::OnlyClient : Data.AccessType != EReplicationAccessType::OnlyServer;
 }
 
-FString UGlobalReplicator::GetValueString(EReplicatedValueType DataType, TArray<uint8> Bytes)
+bool UGlobalReplicator::IsEncodingSupported(EReplicatedValueType DataType, const FPackingEncoding& Encoding)
+{
+	switch (Encoding.EncodingType)
+	{
+	case EPackingEncodingType::Quantized:
+		return DataType == EReplicatedValueType::Float || DataType == EReplicatedValueType::Vector;
+	case EPackingEncodingType::Delta:
+		return DataType == EReplicatedValueType::ByteArray || DataType == EReplicatedValueType::String;
+	default:
+		return true;
+	}
+}
+
+FString UGlobalReplicator::GetValueString(EReplicatedValueType DataType, const FPackingEncoding& Encoding, TArray<uint8> Bytes)
 {
 	switch (DataType)
 	{
 	case EReplicatedValueType::Float:
 		{
-			float Value;
-			UPropertyPackingLibrary::UnpackValue<float>(Bytes, Value);
+			float Value = 0.f;
+			if (Encoding.IsQuantized())
+				UPropertyPackingLibrary::UnpackQuantizedFloat(Bytes, Encoding.Precision, Value);
+			else
+				UPropertyPackingLibrary::UnpackValue<float>(Bytes, Value);
 			return FString::Printf(TEXT("%f"), Value);
 		}
 	case EReplicatedValueType::Bool:
@@ -522,8 +1148,11 @@ FString UGlobalReplicator::GetValueString(EReplicatedValueType DataType, TArray<
 		}
 	case EReplicatedValueType::Vector:
 		{
-			FVector Value;
-			UPropertyPackingLibrary::UnpackValue<FVector>(Bytes, Value);
+			FVector Value = FVector::ZeroVector;
+			if (Encoding.IsQuantized())
+				UPropertyPackingLibrary::UnpackQuantizedVector(Bytes, Encoding.Precision, Value);
+			else
+				UPropertyPackingLibrary::UnpackValue<FVector>(Bytes, Value);
 			return Value.ToString();
 		}
 	case EReplicatedValueType::ByteArray:
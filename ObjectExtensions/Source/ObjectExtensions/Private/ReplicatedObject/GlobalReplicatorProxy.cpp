@@ -1,5 +1,6 @@
 ﻿#include "ReplicatedObject/GlobalReplicatorProxy.h"
 
+#include "GameFramework/PlayerController.h"
 #include "ReplicatedObject/GlobalReplicator.h"
 
 UGlobalReplicatorProxy::UGlobalReplicatorProxy()
@@ -23,7 +24,7 @@ void UGlobalReplicatorProxy::Server_ForwardRequestValue_Implementation(FName Rep
 {
 	if (UGlobalReplicator* Replicator = UGlobalReplicator::Get(this))
 	{
-		Replicator->Server_RequestData(ReplicationKey);
+		Replicator->Server_RequestData(ReplicationKey, Cast<APlayerController>(GetOwner()));
 	}
 	else
 	{
@@ -42,3 +43,15 @@ void UGlobalReplicatorProxy::Server_ForwardDereplicate_Implementation(FName Repl
 		UE_LOG(LogTemp, Warning, TEXT("UGlobalReplicatorProxy: GlobalReplicator component not found."));
 	}
 }
+
+void UGlobalReplicatorProxy::Client_ReceiveUpdate_Implementation(FReplicatedKey ReplicationKey, const TArray<uint8>& NewData, bool OnlyUpdateRequested, bool bFullValue)
+{
+	if (UGlobalReplicator* Replicator = UGlobalReplicator::Get(this))
+	{
+		Replicator->ReceiveUpdate(ReplicationKey, NewData, OnlyUpdateRequested, bFullValue);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Warning, TEXT("UGlobalReplicatorProxy: GlobalReplicator component not found."));
+	}
+}
@@ -13,3 +13,176 @@ float UPropertyPackingLibrary::UnpackFloat(const TArray<uint8>& InValue)
 	UnpackValue<float>(InValue, OutValue);
 	return OutValue;
 }
+
+void UPropertyPackingLibrary::PackQuantizedFloat(float Value, float Precision, TArray<uint8>& OutBytes)
+{
+	OutBytes.Empty();
+	FMemoryWriter Writer(OutBytes);
+	double Component = Value;
+	SerializeQuantizedComponent(Writer, Component, Precision);
+}
+
+bool UPropertyPackingLibrary::UnpackQuantizedFloat(const TArray<uint8>& Bytes, float Precision, float& OutValue)
+{
+	FMemoryReader Reader(Bytes);
+	double Component = 0.0;
+	SerializeQuantizedComponent(Reader, Component, Precision);
+	if (Reader.IsError())
+		return false;
+	
+	OutValue = static_cast<float>(Component);
+	return true;
+}
+
+void UPropertyPackingLibrary::PackQuantizedVector(const FVector& Value, float Precision, TArray<uint8>& OutBytes)
+{
+	OutBytes.Empty();
+	FMemoryWriter Writer(OutBytes);
+	double X = Value.X, Y = Value.Y, Z = Value.Z;
+	SerializeQuantizedComponent(Writer, X, Precision);
+	SerializeQuantizedComponent(Writer, Y, Precision);
+	SerializeQuantizedComponent(Writer, Z, Precision);
+}
+
+bool UPropertyPackingLibrary::UnpackQuantizedVector(const TArray<uint8>& Bytes, float Precision, FVector& OutValue)
+{
+	FMemoryReader Reader(Bytes);
+	double X = 0.0, Y = 0.0, Z = 0.0;
+	SerializeQuantizedComponent(Reader, X, Precision);
+	SerializeQuantizedComponent(Reader, Y, Precision);
+	SerializeQuantizedComponent(Reader, Z, Precision);
+	if (Reader.IsError())
+		return false;
+
+	OutValue = FVector(X, Y, Z);
+	return true;
+}
+
+void UPropertyPackingLibrary::PackDelta(const TArray<uint8>& BaselineBytes, const TArray<uint8>& NewBytes, TArray<uint8>& OutDelta)
+{
+	//Unchanged gaps shorter than this are cheaper to resend than to start a new run for
+	constexpr int32 MinGapBetweenRuns = 4;
+
+	//Runs of changed bytes as (Start, Length)
+	TArray<TPair<int32, int32>> Runs;
+	int32 RunStart = INDEX_NONE;
+	int32 LastChanged = INDEX_NONE;
+
+	auto AddChangedByte = [&](int32 Index)
+	{
+		if (RunStart != INDEX_NONE && Index - LastChanged - 1 >= MinGapBetweenRuns)
+		{
+			Runs.Emplace(RunStart, LastChanged + 1 - RunStart);
+			RunStart = INDEX_NONE;
+		}
+		
+		if (RunStart == INDEX_NONE)
+			RunStart = Index;
+		LastChanged = Index;
+	};
+	
+	const int32 NumCommon = FMath::Min(BaselineBytes.Num(), NewBytes.Num());
+	for (int32 Index = 0; Index < NumCommon; ++Index)
+	{
+		if (BaselineBytes[Index] != NewBytes[Index])
+			AddChangedByte(Index);
+	}
+
+	//Appended bytes always form one run
+	if (NewBytes.Num() > NumCommon)
+	{
+		AddChangedByte(NumCommon);
+		LastChanged = NewBytes.Num() - 1;
+	}
+	
+	if (RunStart != INDEX_NONE)
+		Runs.Emplace(RunStart, LastChanged + 1 - RunStart);
+
+	OutDelta.Empty();
+	FMemoryWriter Writer(OutDelta);
+	
+	uint32 BaselineChecksum = FCrc::MemCrc32(BaselineBytes.GetData(), BaselineBytes.Num());
+	uint32 NewNum = NewBytes.Num();
+	uint32 NumRuns = Runs.Num();
+	Writer << BaselineChecksum;
+	Writer.SerializeIntPacked(NewNum);
+	Writer.SerializeIntPacked(NumRuns);
+
+	int32 PreviousRunEnd = 0;
+	for (const TPair<int32, int32>& Run : Runs)
+	{
+		uint32 Offset = Run.Key - PreviousRunEnd;
+		uint32 Length = Run.Value;
+		Writer.SerializeIntPacked(Offset);
+		Writer.SerializeIntPacked(Length);
+		Writer.Serialize(const_cast<uint8*>(NewBytes.GetData() + Run.Key), Run.Value);
+		PreviousRunEnd = Run.Key + Run.Value;
+	}
+}
+
+bool UPropertyPackingLibrary::ApplyDelta(const TArray<uint8>& BaselineBytes, const TArray<uint8>& Delta, TArray<uint8>& OutBytes)
+{
+	FMemoryReader Reader(Delta);
+	
+	uint32 BaselineChecksum = 0;
+	uint32 NewNum = 0;
+	uint32 NumRuns = 0;
+	Reader << BaselineChecksum;
+	Reader.SerializeIntPacked(NewNum);
+	Reader.SerializeIntPacked(NumRuns);
+
+	if (Reader.IsError() || BaselineChecksum != FCrc::MemCrc32(BaselineBytes.GetData(), BaselineBytes.Num()))
+		return false;
+
+	//A delta can never grow the value by more bytes than it carries
+	if (static_cast<int64>(NewNum) > static_cast<int64>(BaselineBytes.Num()) + Delta.Num())
+		return false;
+
+	TArray<uint8> Result = BaselineBytes;
+	Result.SetNumZeroed(NewNum);
+
+	int64 Position = 0;
+	for (uint32 RunIndex = 0; RunIndex < NumRuns; ++RunIndex)
+	{
+		uint32 Offset = 0;
+		uint32 Length = 0;
+		Reader.SerializeIntPacked(Offset);
+		Reader.SerializeIntPacked(Length);
+		
+		Position += Offset;
+		if (Reader.IsError() || Position + Length > NewNum)
+			return false;
+		
+		Reader.Serialize(Result.GetData() + Position, Length);
+		Position += Length;
+	}
+
+	if (Reader.IsError())
+		return false;
+
+	OutBytes = MoveTemp(Result);
+	return true;
+}
+
+void UPropertyPackingLibrary::SerializeQuantizedComponent(FArchive& Ar, double& Value, float Precision)
+{
+	const double Step = FMath::Max(static_cast<double>(Precision), UE_DOUBLE_SMALL_NUMBER);
+
+	//ZigZag encoded so small negative values stay small after packing
+	uint64 Packed = 0;
+	if (Ar.IsSaving())
+	{
+		//Rounding a quotient outside the int64 range is undefined, clamp to what the encoding can represent
+		const double Steps = FMath::IsNaN(Value) ? 0.0 : Value / Step;
+		const int64 Quantized = FMath::RoundToInt64(FMath::Clamp(Steps, -MaxQuantizedSteps, MaxQuantizedSteps));
+		Packed = (static_cast<uint64>(Quantized) << 1) ^ static_cast<uint64>(Quantized >> 63);
+	}
+	
+	Ar.SerializeIntPacked64(Packed);
+
+	if (Ar.IsLoading())
+	{
+		const int64 Quantized = static_cast<int64>(Packed >> 1) ^ -static_cast<int64>(Packed & 1);
+		Value = Quantized * Step;
+	}
+}
\ No newline at end of file
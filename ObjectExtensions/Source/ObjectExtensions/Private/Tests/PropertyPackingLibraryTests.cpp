@@ -0,0 +1,121 @@
+﻿#include "Misc/AutomationTest.h"
+#include "Save/PropertyPackingLibrary.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPropertyPackingQuantizedFloatTest, "ObjectExtensions.PropertyPacking.QuantizedFloat", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPropertyPackingQuantizedFloatTest::RunTest(const FString& Parameters)
+{
+	const float Precisions[] = { 1.f, 0.1f, 0.01f, 0.001f, 0.000001f };
+	const float Values[] = { 0.f, 0.004f, -0.004f, 0.5f, -0.5f, 1.2345f, -1.2345f, 123.456f, -98765.4f, 1000000.f };
+
+	for (const float Precision : Precisions)
+	{
+		for (const float Value : Values)
+		{
+			TArray<uint8> Bytes;
+			UPropertyPackingLibrary::PackQuantizedFloat(Value, Precision, Bytes);
+
+			float Unpacked = 0.f;
+			if (!TestTrue(FString::Printf(TEXT("Unpack %f at precision %f"), Value, Precision), UPropertyPackingLibrary::UnpackQuantizedFloat(Bytes, Precision, Unpacked)))
+				continue;
+
+			//Half a step, plus the rounding of the unpacked double back to float
+			const double Bound = Precision * 0.5 + FMath::Abs(Value) * FLT_EPSILON;
+			TestTrue(FString::Printf(TEXT("%f at precision %f unpacked as %f"), Value, Precision, Unpacked), FMath::Abs(static_cast<double>(Unpacked) - Value) <= Bound);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPropertyPackingQuantizedVectorTest, "ObjectExtensions.PropertyPacking.QuantizedVector", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPropertyPackingQuantizedVectorTest::RunTest(const FString& Parameters)
+{
+	const float Precisions[] = { 1.f, 0.01f, 0.0001f };
+	const FVector Values[] = { FVector::ZeroVector, FVector(0.004, -0.006, 0.5), FVector(1234.5678, -8765.4321, 0.001), FVector(-250000.25, 125000.75, -3.3) };
+
+	for (const float Precision : Precisions)
+	{
+		for (const FVector& Value : Values)
+		{
+			TArray<uint8> Bytes;
+			UPropertyPackingLibrary::PackQuantizedVector(Value, Precision, Bytes);
+
+			FVector Unpacked;
+			if (!TestTrue(FString::Printf(TEXT("Unpack %s at precision %f"), *Value.ToString(), Precision), UPropertyPackingLibrary::UnpackQuantizedVector(Bytes, Precision, Unpacked)))
+				continue;
+
+			//Components are quantized independently
+			const double Bound = Precision * 0.5 + Value.GetAbsMax() * DBL_EPSILON;
+			const FVector Error = (Unpacked - Value).GetAbs();
+			TestTrue(FString::Printf(TEXT("%s at precision %f unpacked as %s"), *Value.ToString(), Precision, *Unpacked.ToString()), Error.GetMax() <= Bound);
+		}
+	}
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPropertyPackingQuantizedRangeTest, "ObjectExtensions.PropertyPacking.QuantizedRange", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPropertyPackingQuantizedRangeTest::RunTest(const FString& Parameters)
+{
+	//Values beyond the encodable range clamp instead of overflowing
+	const float Precision = 0.000001f;
+	const double MaxValue = UPropertyPackingLibrary::MaxQuantizedSteps * static_cast<double>(Precision);
+	const float Values[] = { FLT_MAX, -FLT_MAX, INFINITY, -INFINITY };
+
+	for (const float Value : Values)
+	{
+		TArray<uint8> Bytes;
+		UPropertyPackingLibrary::PackQuantizedFloat(Value, Precision, Bytes);
+
+		float Unpacked = 0.f;
+		if (!TestTrue(FString::Printf(TEXT("Unpack %f"), Value), UPropertyPackingLibrary::UnpackQuantizedFloat(Bytes, Precision, Unpacked)))
+			continue;
+
+		TestTrue(FString::Printf(TEXT("%f clamps to the encodable range"), Value), FMath::IsNearlyEqual(static_cast<double>(Unpacked), FMath::Sign(Value) * MaxValue, MaxValue * FLT_EPSILON));
+	}
+
+	TArray<uint8> Bytes;
+	UPropertyPackingLibrary::PackQuantizedFloat(NAN, Precision, Bytes);
+	float Unpacked = 1.f;
+	TestTrue(TEXT("NaN unpacks"), UPropertyPackingLibrary::UnpackQuantizedFloat(Bytes, Precision, Unpacked));
+	TestEqual(TEXT("NaN packs as zero"), Unpacked, 0.f);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPropertyPackingDeltaTest, "ObjectExtensions.PropertyPacking.Delta", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPropertyPackingDeltaTest::RunTest(const FString& Parameters)
+{
+	TArray<int32> Baseline;
+	for (int32 Index = 0; Index < 64; ++Index)
+		Baseline.Add(Index);
+
+	TArray<int32> Changed = Baseline;
+	Changed[3] = -3;
+	Changed[40] = 4000;
+	Changed.Add(64);
+
+	TArray<uint8> BaselineBytes;
+	UPropertyPackingLibrary::PackValue(Baseline, BaselineBytes);
+
+	TArray<uint8> NewBytes, Delta;
+	UPropertyPackingLibrary::PackValueDelta(Changed, BaselineBytes, NewBytes, Delta);
+	TestTrue(TEXT("Delta is smaller than the full value"), Delta.Num() < NewBytes.Num());
+
+	TArray<uint8> AppliedBytes;
+	TArray<int32> Unpacked;
+	TestTrue(TEXT("Delta applies to its baseline"), UPropertyPackingLibrary::UnpackValueDelta(BaselineBytes, Delta, AppliedBytes, Unpacked));
+	TestEqual(TEXT("Applied bytes match"), AppliedBytes, NewBytes);
+	TestEqual(TEXT("Unpacked value matches"), Unpacked, Changed);
+
+	//A delta against another baseline is rejected
+	TArray<uint8> OtherBytes;
+	UPropertyPackingLibrary::PackValue(Changed, OtherBytes);
+	TestFalse(TEXT("Delta is rejected for another baseline"), UPropertyPackingLibrary::ApplyDelta(OtherBytes, Delta, AppliedBytes));
+	return true;
+}
+
+#endif
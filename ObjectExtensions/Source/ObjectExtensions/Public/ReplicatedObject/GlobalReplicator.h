@@ -1,9 +1,12 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
 #include "ObjectReplicator.h"
+#include "Save/PropertyPackingLibrary.h"
 #include "GlobalReplicator.generated.h"
 
+class APlayerController;
 class UGlobalReplicatorProxy;
 DECLARE_LOG_CATEGORY_EXTERN(LogGlobalReplicator, Log, All);
 
@@ -35,14 +38,72 @@ struct FReplicatedKey
 public:
 	FReplicatedKey() {  }
 	FReplicatedKey(FName InReplicationKey, uint32 InTimeStamp) : ReplicationKey(InReplicationKey), TimeStamp(InTimeStamp) {}
+	FReplicatedKey(FName InReplicationKey, int32 InKeyID, uint32 InTimeStamp) : ReplicationKey(InReplicationKey), KeyID(InKeyID), TimeStamp(InTimeStamp) {}
 
 	UPROPERTY()
 	FName ReplicationKey = NAME_None;
+	//Interned ID assigned by the server. When valid only the ID is sent over the network, not the name.
+	UPROPERTY()
+	int32 KeyID = INDEX_NONE;
 	UPROPERTY()
 	uint32 TimeStamp = 0;
+
+	bool HasKeyID() const { return KeyID != INDEX_NONE; }
+	
+	bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
 };
+
+template<>
+struct TStructOpsTypeTraits<FReplicatedKey> : public TStructOpsTypeTraitsBase2<FReplicatedKey>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+//Maps the C++ types supported by the Global Replicator to their EReplicatedValueType. Unsupported types fail to compile.
+template<typename T>
+struct TGlobalReplicatedType;
+
+template<> struct TGlobalReplicatedType<float> { static constexpr EReplicatedValueType Type = EReplicatedValueType::Float; };
+template<> struct TGlobalReplicatedType<bool> { static constexpr EReplicatedValueType Type = EReplicatedValueType::Bool; };
+template<> struct TGlobalReplicatedType<int32> { static constexpr EReplicatedValueType Type = EReplicatedValueType::Int; };
+template<> struct TGlobalReplicatedType<TArray<uint8>> { static constexpr EReplicatedValueType Type = EReplicatedValueType::ByteArray; };
+template<> struct TGlobalReplicatedType<FString> { static constexpr EReplicatedValueType Type = EReplicatedValueType::String; };
+template<> struct TGlobalReplicatedType<FVector> { static constexpr EReplicatedValueType Type = EReplicatedValueType::Vector; };
 #pragma endregion
 
+class UGlobalReplicator;
+
+/**
+ * Typed C++ handle to a Global Replicator key.
+ * Reads go straight to the registered variable, there is no unpacking involved.
+ */
+template<typename T>
+class TGlobalReplicatedHandle
+{
+public:
+	TGlobalReplicatedHandle() {  }
+	TGlobalReplicatedHandle(UGlobalReplicator* InReplicator, FName InReplicationKey) : Replicator(InReplicator), ReplicationKey(InReplicationKey) {  }
+
+	bool IsValid() const { return Get() != nullptr; }
+	FName GetKey() const { return ReplicationKey; }
+
+	//Current value, nullptr if the key is not replicated (anymore)
+	const T* Get() const;
+	//Same as changing the registered variable, replicated on the next tick
+	bool Set(const T& NewValue) const;
+	//Same semantics as the OnChanged callback of the replicate functions, including the initial call with the current value.
+	//Returns an invalid handle if the key is not replicated (anymore).
+	FDelegateHandle Subscribe(TFunction<void(const T&)> OnChanged, bool bLocalCallOnChange = true) const;
+	bool Unsubscribe(FDelegateHandle Handle) const;
+
+private:
+	TWeakObjectPtr<UGlobalReplicator> Replicator;
+	FName ReplicationKey = NAME_None;
+};
+
 DECLARE_DYNAMIC_DELEGATE(FOnReplicatedValueChanged);
 
 UCLASS()
@@ -54,6 +115,7 @@ public:
 	UGlobalReplicator();
 	
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 	UFUNCTION(BlueprintCallable, BlueprintPure, DisplayName = "Get Unique ID From Object", Category = "Global Replicator|Helpers", meta = (AdvancedDisplay = 1))
 	static FName GetUniqueIDFromObject(UObject* Object, FString Suffix = "");
@@ -61,6 +123,21 @@ public:
 	UFUNCTION(BlueprintCallable, DisplayName = "Get Global Replicator", Category = "Global Replicator", meta = (WorldContext = "WorldContext"))
 	static UGlobalReplicator* Get(UObject* WorldContext);
 	
+	//Typed registration, the Blueprint replicate functions are built on top of this.
+	//Fails and returns an invalid handle if the key is already replicated with a different type.
+	template<typename T>
+	TGlobalReplicatedHandle<T> Replicate(
+		FName ReplicationKey,
+		T& InValue,
+		TFunction<void(const T&)> OnChanged = nullptr,
+		bool bLocalCallOnChange = true,
+		EReplicationAccessType AccessType = EReplicationAccessType::Both,
+		bool bGetValueFromServer = true);
+
+	//Handle to an already replicated key. Invalid if the key is not replicated or has a different type.
+	template<typename T>
+	TGlobalReplicatedHandle<T> FindReplicated(FName ReplicationKey);
+	
 	UFUNCTION(BlueprintCallable, Category = "Global Replicator", meta = (AdvancedDisplay = 3))
 	void ReplicateFloat(
 		FName ReplicationKey,
@@ -120,17 +197,45 @@ public:
 		FName ReplicationKey,
 		bool bPropagateToRemote = true);
 
+	//Quantized is supported for Float and Vector keys, Delta for ByteArray and String keys.
+	//Has to be set the same way on the server and all clients. Can be set before or after the key is replicated.
+	UFUNCTION(BlueprintCallable, Category = "Global Replicator")
+	bool SetReplicationEncoding(
+		FName ReplicationKey,
+		FPackingEncoding Encoding);
+
+	//Scopes a key so the server only sends it to connections whose pawn or player state reports the tag as relevant through IReplicationRelevancy.
+	//Connections that become relevant receive the current value of all keys scoped to the tag. An invalid tag sends the key to everyone again.
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Global Replicator")
+	void SetReplicationRelevancy(
+		FName ReplicationKey,
+		FGameplayTag RelevancyTag);
+
+	//Relevancy providers call this when the tags they are relevant for changed, the connection owning the pawn or player state is refreshed on the next tick
+	UFUNCTION(BlueprintCallable, BlueprintAuthorityOnly, Category = "Global Replicator")
+	void MarkRelevancyDirty(AActor* RelevancyActor);
+
+	//Seconds between refreshes of all connections, catches changes that were not marked dirty. 0 refreshes every tick.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Global Replicator", meta = (ClampMin = 0))
+	float RelevancyRefreshInterval = 1.f;
+
 protected:
 
 	friend UGlobalReplicatorProxy;
+	template<typename T>
+	friend class TGlobalReplicatedHandle;
 	//RPCs
 	void Server_UpdateData(FReplicatedKey ReplicationKey, const TArray<uint8>& NewData, bool OnlyUpdateRequested);
-	void Server_RequestData(FName ReplicationKey);
+	void Server_RequestData(FName ReplicationKey, APlayerController* Requester = nullptr);
 	void Server_DereplicateData(FName ReplicationKey);
 	UFUNCTION(NetMulticast, Reliable)
 	void Multicast_UpdateData(FReplicatedKey ReplicationKey, const TArray<uint8>& NewData, bool OnlyUpdateRequested = false);
 	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_DereplicateData(FName ReplicationKey);
+	void Multicast_DereplicateData(FReplicatedKey ReplicationKey);
+
+	//Key Interning
+	UFUNCTION()
+	void OnRep_InternedKeys();
 	
 private:
 	
@@ -143,6 +248,8 @@ private:
 			
 			TFunction<void(const TArray<uint8>&)> Callback {};
 			bool bLocalCallOnChange = true;
+			//Only set for callbacks added through a typed handle
+			FDelegateHandle Handle;
 		};
 		
 		//Original Variable
@@ -155,14 +262,72 @@ private:
 		EReplicationAccessType AccessType;
 		//Data Type
 		EReplicatedValueType DataType;
+		//Encoding of LastSentBytes and of the multicast payloads
+		FPackingEncoding Encoding;
 		//CallBacks
 		TArray<FCallBackPair> Callbacks;
 		//NOT FULLY USED - for replication validation in the future
 		bool bPendingLocalUpdate = false;
 	};
 
+	//Messages received before the interned key table resolved their ID
+	struct FPendingKeyMessage
+	{
+		FReplicatedKey ReplicationKey;
+		TArray<uint8> Data;
+		bool bOnlyUpdateRequested = false;
+		bool bFullValue = false;
+		bool bDereplicate = false;
+		double ReceiveTime = 0;
+	};
+
+	//Unresolved messages are dropped once the queue is full or they are too old
+	static constexpr int32 MaxPendingKeyMessages = 256;
+	static constexpr double PendingKeyMessageTimeout = 10.0;
+	//Released keys keep their ID this long before it is cleared and again before it is reused,
+	//so messages and key tables that are still in flight resolve to the right name
+	static constexpr double KeyReleaseDelay = 30.0;
+
+	//Last value of a scoped key the server relays but has not registered itself
+	struct FScopedKeyValue
+	{
+		TArray<uint8> Bytes;
+		uint32 TimeStamp = 0;
+	};
+
+	//Objects implementing IReplicationRelevancy, collected again once the pawn or player state changes
+	struct FRelevancyProviders
+	{
+		TWeakObjectPtr<AActor> Pawn;
+		TWeakObjectPtr<AActor> PlayerState;
+		TArray<TWeakObjectPtr<UObject>> Objects;
+		bool bCollected = false;
+	};
+
 	//Data
 	TMap<FName, FLocalData> ReplicatedDataMap;
+	//Encodings set before their key was replicated
+	TMap<FName, FPackingEncoding> PendingEncodings;
+
+	//Key Interning - the index of a key in this array is its ID, released IDs hold NAME_None until they are reused
+	UPROPERTY(ReplicatedUsing = OnRep_InternedKeys)
+	TArray<FName> InternedKeys;
+	TMap<FName, int32> InternedKeyIDs;
+	TArray<FPendingKeyMessage> PendingKeyMessages;
+	//Server only - keys waiting to be released and released IDs waiting to be reused, oldest first
+	TMap<FName, double> PendingKeyReleases;
+	TArray<TPair<int32, double>> FreeKeyIDs;
+
+	//Relevancy - server only
+	TMap<FName, FGameplayTag> KeyRelevancyTags;
+	TMap<FGameplayTag, TArray<FName>> ScopedKeysByTag;
+	TMap<FName, FScopedKeyValue> RelayedScopedValues;
+	TMap<TWeakObjectPtr<APlayerController>, FGameplayTagContainer> RelevantTagsByController;
+	TMap<TWeakObjectPtr<APlayerController>, FRelevancyProviders> RelevancyProvidersByController;
+	TSet<TWeakObjectPtr<APlayerController>> DirtyRelevancyControllers;
+	bool bAllRelevancyDirty = false;
+	double NextRelevancyRefreshTime = 0;
+	
 	UPROPERTY()
 	mutable TObjectPtr<UGlobalReplicatorProxy> ClientReplicatorProxy = nullptr;
 	
@@ -170,7 +335,7 @@ private:
 	uint32 GetCurrentTimeStamp() const;
 
 	//Helpers
-	void InternalReplicate(
+	bool InternalReplicate(
 		FName ReplicationKey,
 		void* ValuePtr,
 		EReplicatedValueType DataType,
@@ -179,12 +344,139 @@ private:
 		EReplicationAccessType AccessType,
 		bool bGetValueFromServer);
 	
-	void PackCurrentValue(void* ValuePtr, EReplicatedValueType DataType, TArray<uint8>& OutBytes) const;
+	//Key Interning
+	int32 InternKey(FName ReplicationKey);
+	FReplicatedKey MakeReplicatedKey(FName ReplicationKey, uint32 TimeStamp);
+	FName ResolveReplicatedKey(const FReplicatedKey& ReplicationKey) const;
+	void QueuePendingKeyMessage(FPendingKeyMessage&& Message);
+	void PrunePendingKeyMessages();
+	void FlushPendingKeyMessages();
+	void ScheduleKeyRelease(FName ReplicationKey);
+	void ReleaseUnreferencedKeys();
+	bool IsKeyReferenced(FName ReplicationKey) const;
+
+	//Typed Access
+	template<typename T>
+	T* FindTypedValue(FName ReplicationKey) const;
+	template<typename T>
+	FDelegateHandle AddTypedCallback(FName ReplicationKey, TFunction<void(const T&)> OnChanged, bool bLocalCallOnChange);
+	bool RemoveCallback(FName ReplicationKey, FDelegateHandle Handle);
+
+	//Receiving
+	void ReceiveUpdate(const FReplicatedKey& ReplicationKey, const TArray<uint8>& NewData, bool OnlyUpdateRequested, bool bFullValue);
+
+	//Relevancy
+	void SendUpdate(FName ReplicationKey, const FReplicatedKey& ReplicatedKey, const TArray<uint8>& Payload, bool OnlyUpdateRequested, const TArray<uint8>& FullBytes);
+	void SendFullValue(APlayerController* PlayerController, FName ReplicationKey, bool OnlyUpdateRequested);
+	bool GetServerValue(FName ReplicationKey, TArray<uint8>& OutBytes, uint32& OutTimeStamp) const;
+	void RefreshRelevancy();
+	void RefreshControllerRelevancy(APlayerController* PlayerController);
+	const FRelevancyProviders& GetRelevancyProviders(const APlayerController* PlayerController);
+	static bool IsTagRelevantForProviders(const FRelevancyProviders& Providers, FGameplayTag RelevancyTag);
+	
+	void PackCurrentValue(void* ValuePtr, EReplicatedValueType DataType, const FPackingEncoding& Encoding, TArray<uint8>& OutBytes) const;
+	void EncodeForMulticast(const FLocalData& Data, const TArray<uint8>& NewBytes, TArray<uint8>& OutPayload) const;
 	void ApplyLastSentData(FLocalData& Data);
 	bool DeleteData(FName ReplicationKey);
 	bool HasAuthorityToChange(const FLocalData& Data) const;
+	static bool IsEncodingSupported(EReplicatedValueType DataType, const FPackingEncoding& Encoding);
 
 	//Debug
-	static FString GetValueString(EReplicatedValueType DataType, TArray<uint8> Bytes);
+	static FString GetValueString(EReplicatedValueType DataType, const FPackingEncoding& Encoding, TArray<uint8> Bytes);
 	static FString GetValueString(EReplicatedValueType DataType, void* ValuePtr);
-};
\ No newline at end of file
+};
+
+#pragma region Typed Access
+template<typename T>
+TGlobalReplicatedHandle<T> UGlobalReplicator::Replicate(FName ReplicationKey, T& InValue, TFunction<void(const T&)> OnChanged, bool bLocalCallOnChange, EReplicationAccessType AccessType, bool bGetValueFromServer)
+{
+	//The value is read from the registered variable, which may not be InValue if the key was replicated before
+	auto CallbackWrapper = [this, ReplicationKey, OnChanged](const TArray<uint8>& Data)
+	{
+		if (!OnChanged)
+			return;
+		
+		if (const T* Value = FindTypedValue<T>(ReplicationKey))
+			OnChanged(*Value);
+	};
+
+	if (!InternalReplicate(ReplicationKey, static_cast<void*>(&InValue), TGlobalReplicatedType<T>::Type, CallbackWrapper, bLocalCallOnChange, AccessType, bGetValueFromServer))
+		return TGlobalReplicatedHandle<T>();
+
+	return TGlobalReplicatedHandle<T>(this, ReplicationKey);
+}
+
+template<typename T>
+TGlobalReplicatedHandle<T> UGlobalReplicator::FindReplicated(FName ReplicationKey)
+{
+	if (!FindTypedValue<T>(ReplicationKey))
+		return TGlobalReplicatedHandle<T>();
+	
+	return TGlobalReplicatedHandle<T>(this, ReplicationKey);
+}
+
+template<typename T>
+T* UGlobalReplicator::FindTypedValue(FName ReplicationKey) const
+{
+	const FLocalData* Data = ReplicatedDataMap.Find(ReplicationKey);
+	if (!Data || !Data->ValuePtr || Data->DataType != TGlobalReplicatedType<T>::Type)
+		return nullptr;
+	
+	return static_cast<T*>(Data->ValuePtr);
+}
+
+template<typename T>
+FDelegateHandle UGlobalReplicator::AddTypedCallback(FName ReplicationKey, TFunction<void(const T&)> OnChanged, bool bLocalCallOnChange)
+{
+	FLocalData* Data = ReplicatedDataMap.Find(ReplicationKey);
+	if (!Data || Data->DataType != TGlobalReplicatedType<T>::Type || !OnChanged)
+		return FDelegateHandle();
+
+	auto CallbackWrapper = [this, ReplicationKey, OnChanged](const TArray<uint8>& Bytes)
+	{
+		if (const T* Value = FindTypedValue<T>(ReplicationKey))
+			OnChanged(*Value);
+	};
+	FLocalData::FCallBackPair& CallbackPair = Data->Callbacks.Add_GetRef(FLocalData::FCallBackPair(CallbackWrapper, bLocalCallOnChange));
+	CallbackPair.Handle = FDelegateHandle(FDelegateHandle::GenerateNewHandle);
+	const FDelegateHandle Handle = CallbackPair.Handle;
+
+	//Same as binding to an already replicated key through InternalReplicate
+	if (bLocalCallOnChange)
+		CallbackWrapper(Data->LastSentBytes);
+	return Handle;
+}
+
+template<typename T>
+const T* TGlobalReplicatedHandle<T>::Get() const
+{
+	const UGlobalReplicator* ReplicatorPtr = Replicator.Get();
+	return ReplicatorPtr ? ReplicatorPtr->template FindTypedValue<T>(ReplicationKey) : nullptr;
+}
+
+template<typename T>
+bool TGlobalReplicatedHandle<T>::Set(const T& NewValue) const
+{
+	UGlobalReplicator* ReplicatorPtr = Replicator.Get();
+	T* Value = ReplicatorPtr ? ReplicatorPtr->template FindTypedValue<T>(ReplicationKey) : nullptr;
+	if (!Value)
+		return false;
+
+	*Value = NewValue;
+	return true;
+}
+
+template<typename T>
+FDelegateHandle TGlobalReplicatedHandle<T>::Subscribe(TFunction<void(const T&)> OnChanged, bool bLocalCallOnChange) const
+{
+	UGlobalReplicator* ReplicatorPtr = Replicator.Get();
+	return ReplicatorPtr ? ReplicatorPtr->template AddTypedCallback<T>(ReplicationKey, MoveTemp(OnChanged), bLocalCallOnChange) : FDelegateHandle();
+}
+
+template<typename T>
+bool TGlobalReplicatedHandle<T>::Unsubscribe(FDelegateHandle Handle) const
+{
+	UGlobalReplicator* ReplicatorPtr = Replicator.Get();
+	return ReplicatorPtr && ReplicatorPtr->RemoveCallback(ReplicationKey, Handle);
+}
+#pragma endregion
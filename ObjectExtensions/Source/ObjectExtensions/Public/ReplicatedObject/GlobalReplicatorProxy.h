@@ -22,4 +22,8 @@ public:
 
 	UFUNCTION(Server, Reliable)
 	void Server_ForwardDereplicate(FName ReplicationKey);
+
+	//Used instead of the multicast for relevancy scoped keys
+	UFUNCTION(Client, Reliable)
+	void Client_ReceiveUpdate(FReplicatedKey ReplicationKey, const TArray<uint8>& NewData, bool OnlyUpdateRequested, bool bFullValue);
 };
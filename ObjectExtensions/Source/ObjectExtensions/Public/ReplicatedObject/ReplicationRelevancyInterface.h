@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "UObject/Interface.h"
+#include "ReplicationRelevancyInterface.generated.h"
+
+// This class does not need to be modified.
+UINTERFACE()
+class UReplicationRelevancy : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Implemented by pawns, player states or their components to decide which relevancy scoped
+ * Global Replicator keys are sent to the owning connection.
+ */
+class OBJECTEXTENSIONS_API IReplicationRelevancy
+{
+	GENERATED_BODY()
+
+public:
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = "Global Replicator")
+	bool IsRelevantForTag(FGameplayTag RelevancyTag) const;
+};
@@ -4,9 +4,38 @@
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "PropertyPackingLibrary.generated.h"
 
-/**
- * 
- */
+#pragma region Enums and Structs
+UENUM(BlueprintType)
+enum class EPackingEncodingType : uint8
+{
+	//Full precision, the value is serialized as is.
+	Raw,
+	//Floats and vectors are stored as variable length integers in steps of the configured precision.
+	Quantized,
+	//Only the byte ranges that changed against the last acknowledged bytes are stored.
+	Delta,
+};
+
+USTRUCT(BlueprintType)
+struct OBJECTEXTENSIONS_API FPackingEncoding
+{
+	GENERATED_BODY()
+
+public:
+	FPackingEncoding() {  }
+	FPackingEncoding(EPackingEncodingType InEncodingType, float InPrecision = 0.01f) : EncodingType(InEncodingType), Precision(InPrecision) {}
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Property Packing")
+	EPackingEncodingType EncodingType = EPackingEncodingType::Raw;
+	//Quantization step. Unpacked values are within half of this of the original.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Property Packing", meta = (ClampMin = "0.000001", EditCondition = "EncodingType == EPackingEncodingType::Quantized", EditConditionHides))
+	float Precision = 0.01f;
+
+	bool IsQuantized() const { return EncodingType == EPackingEncodingType::Quantized; }
+	bool IsDelta() const { return EncodingType == EPackingEncodingType::Delta; }
+};
+#pragma endregion
+
 UCLASS()
 class OBJECTEXTENSIONS_API UPropertyPackingLibrary : public UBlueprintFunctionLibrary
 {
@@ -24,6 +53,28 @@ public:
 	static void PackValue(const T& Value, TArray<uint8>& OutBytes);
 	template<typename T>
 	static void UnpackValue(const TArray<uint8>& Bytes, T& OutValue);
+
+	//Quantized
+	//Values beyond MaxQuantizedSteps * Precision are clamped to that range, NaN packs as zero.
+	static constexpr double MaxQuantizedSteps = 4611686018427387904.0; //2^62
+	static void PackQuantizedFloat(float Value, float Precision, TArray<uint8>& OutBytes);
+	static bool UnpackQuantizedFloat(const TArray<uint8>& Bytes, float Precision, float& OutValue);
+	static void PackQuantizedVector(const FVector& Value, float Precision, TArray<uint8>& OutBytes);
+	static bool UnpackQuantizedVector(const TArray<uint8>& Bytes, float Precision, FVector& OutValue);
+
+	//Delta
+	//Writes the changed byte ranges of NewBytes against BaselineBytes, tagged with a checksum of the baseline.
+	static void PackDelta(const TArray<uint8>& BaselineBytes, const TArray<uint8>& NewBytes, TArray<uint8>& OutDelta);
+	//Fails without touching OutBytes if the delta was not made against BaselineBytes.
+	static bool ApplyDelta(const TArray<uint8>& BaselineBytes, const TArray<uint8>& Delta, TArray<uint8>& OutBytes);
+	
+	template<typename T>
+	static void PackValueDelta(const T& Value, const TArray<uint8>& BaselineBytes, TArray<uint8>& OutBytes, TArray<uint8>& OutDelta);
+	template<typename T>
+	static bool UnpackValueDelta(const TArray<uint8>& BaselineBytes, const TArray<uint8>& Delta, TArray<uint8>& OutBytes, T& OutValue);
+
+private:
+	static void SerializeQuantizedComponent(FArchive& Ar, double& Value, float Precision);
 };
 
 template<typename T>
@@ -39,4 +90,21 @@ inline void UPropertyPackingLibrary::UnpackValue(const TArray<uint8>& Bytes, T&
 {
 	FMemoryReader Reader(Bytes);
 	Reader << OutValue;
+}
+
+template<typename T>
+inline void UPropertyPackingLibrary::PackValueDelta(const T& Value, const TArray<uint8>& BaselineBytes, TArray<uint8>& OutBytes, TArray<uint8>& OutDelta)
+{
+	PackValue<T>(Value, OutBytes);
+	PackDelta(BaselineBytes, OutBytes, OutDelta);
+}
+
+template<typename T>
+inline bool UPropertyPackingLibrary::UnpackValueDelta(const TArray<uint8>& BaselineBytes, const TArray<uint8>& Delta, TArray<uint8>& OutBytes, T& OutValue)
+{
+	if (!ApplyDelta(BaselineBytes, Delta, OutBytes))
+		return false;
+	
+	UnpackValue<T>(OutBytes, OutValue);
+	return true;
 }
\ No newline at end of file
@@ -313,6 +313,7 @@ void UElectricityModule::NewParent_Implementation(URegion* OldParentRegion, UReg
             Module->RegisterPowerConsumer(this);
             Module->RegisterPowerProvider(this);
         }
+        PreviousParentModule = Module;
     }
 }
 
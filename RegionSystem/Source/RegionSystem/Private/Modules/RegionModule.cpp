@@ -78,9 +78,9 @@ URegionModule* URegionModule::GetRegionModule(TSubclassOf<URegionModule> ModuleC
 
 URegionModule* URegionModule::GetParentRegionModule(TSubclassOf<URegionModule> ModuleClass, bool AllowParentSearch) const
 {
-	if (auto OwningRegion = GetParentRegion())
+	if (auto OwningRegion = GetOwningRegion())
 	{
-		return OwningRegion->GetRegionModule(ModuleClass, AllowParentSearch);
+		return OwningRegion->GetParentRegionModule(ModuleClass, AllowParentSearch);
 	}
 	return nullptr;
 }
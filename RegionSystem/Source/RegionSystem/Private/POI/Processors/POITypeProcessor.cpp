@@ -11,7 +11,16 @@ FLocationCache UPOITypeProcessor::GetPOIRelevantPoints(ARegionPOI* POI) const
 {
 	TArray<FVector> Points {};
 	bool bIsLocal {};
-	CalculateRelevantPoints(POI, Points, bIsLocal);
+	if (IsInGameThread())
+	{
+		CalculateRelevantPoints(POI, Points, bIsLocal);
+	}
+	else
+	{
+		//The event would go through ProcessEvent, which is game thread only
+		check(CanCalculateInParallel());
+		CalculateRelevantPoints_Implementation(POI, Points, bIsLocal);
+	}
 
 	if (!bIsLocal)
 		MakeArrayLocal(Points, POI->GetActorLocation());
@@ -34,6 +43,11 @@ FLocationCache UPOITypeProcessor::GetPOIRelevantPoints(ARegionPOI* POI) const
 	return Cache;
 }
 
+bool UPOITypeProcessor::CanCalculateInParallel() const
+{
+	return SupportsParallelCalculation() && !GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UPOITypeProcessor, CalculateRelevantPoints));
+}
+
 void UPOITypeProcessor::MakeArrayLocal(TArray<FVector>& Array, const FVector& Origin) const
 {
 	for (auto& Vector : Array)
@@ -1,5 +1,6 @@
 ﻿#include "POI/RegionPOI.h"
 
+#include "Region.h"
 #include "RegionSubsystem.h"
 #include "RegionVolume.h"
 #include "Components/BillboardComponent.h"
@@ -8,6 +9,9 @@
 #include "POI/Processors/CustomGrid.h"
 #include "POI/Processors/POITypeProcessor.h"
 #include "Settings/RegionSettings.h"
+#include "Misc/Crc.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
 
 bool FLocationCache::IsLocal() const
 {
@@ -115,7 +119,7 @@ void ARegionPOI::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyCh
 {
 	Super::PostEditChangeProperty(PropertyChangedEvent);
 
-	Recalculate();
+	RecalculateIfChanged();
 	POIRenderer->MarkRenderStateDirty();
 
 	if (URegionSettings::Get()->bAutoBakePOIs)
@@ -129,8 +133,8 @@ void ARegionPOI::PostEditMove(bool bFinished)
 	if (!bFinished)
 		return;
 	
-	Recalculate();
 	ReevaluateRegion();
+	RecalculateIfChanged();
 	POIRenderer->MarkRenderStateDirty();
 
 	if (URegionSettings::Get()->bAutoBakePOIs)
@@ -178,10 +182,92 @@ void ARegionPOI::ReevaluateRegion()
 void ARegionPOI::Recalculate()
 {
 	if (POITypeProcessor)
+		ApplyRelevantPoints(CalculateRelevantPoints(), CalculateInputHash());
+}
+
+bool ARegionPOI::RecalculateIfChanged(FPOICacheStats* Stats)
+{
+	if (!POITypeProcessor)
+		return false;
+
+	const uint32 InputHash = CalculateInputHash();
+	if (IsCalculationCurrent(InputHash))
+	{
+		if (Stats)
+			Stats->Hits++;
+		return true;
+	}
+
+	if (Stats)
+		Stats->Misses++;
+	ApplyRelevantPoints(CalculateRelevantPoints(), InputHash);
+	return false;
+}
+
+bool ARegionPOI::CanCalculateInParallel() const
+{
+	return POITypeProcessor && POITypeProcessor->CanCalculateInParallel();
+}
+
+FLocationCache ARegionPOI::CalculateRelevantPoints()
+{
+	return POITypeProcessor ? POITypeProcessor->GetPOIRelevantPoints(this) : FLocationCache();
+}
+
+void ARegionPOI::ApplyRelevantPoints(FLocationCache&& InRelevantPoints, const uint32 InputHash)
+{
+	RelevantPoints = MoveTemp(InRelevantPoints);
+	RelevantPointsHash = InputHash;
+	POIRenderer->MarkRenderStateDirty();
+}
+
+uint32 ARegionPOI::CalculateInputHash(const FGameplayTag& RegionTag) const
+{
+	TArray<uint8> Bytes;
+	FMemoryWriter Writer(Bytes);
+
+	//POI placement, the processors work relative to it
+	FTransform Transform = GetActorTransform();
+	Writer << Transform;
+
+	//Processor class and settings, object references are written as paths
+	if (POITypeProcessor)
+	{
+		FString ClassPath = POITypeProcessor->GetClass()->GetPathName();
+		Writer << ClassPath;
+
+		FObjectAndNameAsStringProxyArchive ProcessorArchive(Writer, false);
+		POITypeProcessor->GetClass()->SerializeTaggedProperties(ProcessorArchive, reinterpret_cast<uint8*>(POITypeProcessor.Get()), POITypeProcessor->GetClass(), nullptr);
+	}
+
+	//Containing region volumes, sorted so the volume order does not matter
+	FGameplayTag HashedRegionTag = RegionTag;
+	Writer << HashedRegionTag;
+	URegionSubsystem* RegionSubsystem = URegionSubsystem::Get(this);
+	if (URegion* Region = RegionSubsystem ? RegionSubsystem->GetRegionByTag(RegionTag, false) : nullptr)
 	{
-		RelevantPoints.Clear();
-		RelevantPoints = POITypeProcessor->GetPOIRelevantPoints(this);
-		POIRenderer->MarkRenderStateDirty();
-	}	
+		TArray<uint32> VolumeHashes;
+		for (const ARegionVolume* Volume : Region->GetRegionVolumes())
+		{
+			if (!Volume)
+				continue;
+
+			TArray<uint8> VolumeBytes;
+			FMemoryWriter VolumeWriter(VolumeBytes);
+			FTransform VolumeTransform = Volume->GetBoxTransform();
+			FVector VolumeExtent = Volume->GetUnscaledBoxExtent();
+			VolumeWriter << VolumeTransform << VolumeExtent;
+			VolumeHashes.Add(FCrc::MemCrc32(VolumeBytes.GetData(), VolumeBytes.Num()));
+		}
+		VolumeHashes.Sort();
+		Writer << VolumeHashes;
+	}
+
+	//Navigation the processors project onto
+	uint32 NavigationHash = RegionSubsystem ? RegionSubsystem->GetNavigationHash(RegionTag) : 0;
+	Writer << NavigationHash;
+
+	//0 is reserved for points that were never calculated
+	return FMath::Max(1u, FCrc::MemCrc32(Bytes.GetData(), Bytes.Num()));
 }
 #endif
\ No newline at end of file
@@ -44,6 +44,7 @@ void URegion::EndRegion()
 
 	Volumes.Empty();
 	RegionModules.Empty();
+	InvalidateModuleCache();
 }
 
 void URegion::OnNewChild(URegion* NewChild)
@@ -56,6 +57,8 @@ void URegion::OnNewChild(URegion* NewChild)
 
 void URegion::OnNewParent(URegion* OldParent, URegion* NewParent)
 {
+	InvalidateInheritedModuleCache();
+
 	for (auto RegionModule : RegionModules)
 	{
 		RegionModule->NewParent(OldParent, NewParent);
@@ -104,14 +107,128 @@ bool URegion::Contains(FVector Location) const
 
 bool URegion::ContainsFully(const FVector Location, const FVector BoxExtents) const
 {
-	//TODO: Returns false when box is divided up on multiple volumes which needs to be fixed
+	//Fast path, a single volume holds the whole box
 	for (auto VolumePair : Volumes)
 	{
 		check(VolumePair.Key);
 		if (VolumePair.Key->ContainsFully(Location, BoxExtents))
 			return true;
 	}
-	return false;
+	if (Volumes.Num() <= 1)
+		return false;
+
+	//The box may still be split up over several volumes
+	const FBox Box(Location - BoxExtents.GetAbs(), Location + BoxExtents.GetAbs());
+	TArray<FRegionCoverageVolume, TInlineAllocator<8>> CoverageVolumes;
+	for (auto VolumePair : Volumes)
+	{
+		FRegionCoverageVolume CoverageVolume(VolumePair.Key->GetBoxTransform(), VolumePair.Key->GetUnscaledBoxExtent());
+		if (CoverageVolume.Overlaps(Box))
+			CoverageVolumes.Add(CoverageVolume);
+	}
+	if (CoverageVolumes.Num() <= 1)
+		return false;
+
+	return IsCoveredByVolumes(Box, CoverageVolumes, 0);
+}
+
+URegion::FRegionCoverageVolume::FRegionCoverageVolume(const FTransform& InTransform, const FVector& InExtent)
+	: Transform(InTransform)
+	, Extent(InExtent)
+	, Bounds(FBox(-InExtent, InExtent).TransformBy(InTransform))
+{
+	//Axis aligned if every box axis lines up with a world axis, the bounds are then exact
+	const FQuat Rotation = InTransform.GetRotation();
+	bAxisAligned = true;
+	for (const FVector& Axis : { Rotation.GetAxisX(), Rotation.GetAxisY(), Rotation.GetAxisZ() })
+	{
+		const FVector AbsAxis = Axis.GetAbs();
+		bAxisAligned &= AbsAxis.GetMax() >= 1.0 - UE_KINDA_SMALL_NUMBER;
+	}
+}
+
+bool URegion::FRegionCoverageVolume::Overlaps(const FBox& Box) const
+{
+	//Only touching faces do not count as overlapping
+	return Box.Min.X < Bounds.Max.X - UE_KINDA_SMALL_NUMBER && Box.Max.X > Bounds.Min.X + UE_KINDA_SMALL_NUMBER &&
+		Box.Min.Y < Bounds.Max.Y - UE_KINDA_SMALL_NUMBER && Box.Max.Y > Bounds.Min.Y + UE_KINDA_SMALL_NUMBER &&
+		Box.Min.Z < Bounds.Max.Z - UE_KINDA_SMALL_NUMBER && Box.Max.Z > Bounds.Min.Z + UE_KINDA_SMALL_NUMBER;
+}
+
+bool URegion::FRegionCoverageVolume::ContainsPoint(const FVector& Point) const
+{
+	const FVector LocalPoint = Transform.InverseTransformPosition(Point);
+	return FMath::Abs(LocalPoint.X) <= Extent.X + UE_KINDA_SMALL_NUMBER &&
+		FMath::Abs(LocalPoint.Y) <= Extent.Y + UE_KINDA_SMALL_NUMBER &&
+		FMath::Abs(LocalPoint.Z) <= Extent.Z + UE_KINDA_SMALL_NUMBER;
+}
+
+bool URegion::FRegionCoverageVolume::ContainsBox(const FBox& Box) const
+{
+	//Volumes are convex, so holding every corner means holding the box
+	for (int32 Corner = 0; Corner < 8; Corner++)
+	{
+		const FVector Point((Corner & 1) ? Box.Max.X : Box.Min.X, (Corner & 2) ? Box.Max.Y : Box.Min.Y, (Corner & 4) ? Box.Max.Z : Box.Min.Z);
+		if (!ContainsPoint(Point))
+			return false;
+	}
+	return true;
+}
+
+bool URegion::IsCoveredByVolumes(const FBox& Box, TConstArrayView<FRegionCoverageVolume> CoverageVolumes, int32 Depth)
+{
+	bool bOverlapsAny = false;
+	for (const FRegionCoverageVolume& Volume : CoverageVolumes)
+	{
+		if (!Volume.Overlaps(Box))
+			continue;
+		if (Volume.ContainsBox(Box))
+			return true;
+		bOverlapsAny = true;
+	}
+	if (!bOverlapsAny)
+		return false;
+
+	//Rotated volumes are only resolved down to this depth. No single volume holds the remaining cell,
+	//a gap narrower than the cell could pass between sampled points, so it fails closed
+	if (Depth >= MaxCoverageDepth)
+		return false;
+
+	//Split on a face of an axis aligned volume, which makes the result exact for them, otherwise split in the middle
+	int32 SplitAxis = INDEX_NONE;
+	double SplitValue = 0;
+	for (const FRegionCoverageVolume& Volume : CoverageVolumes)
+	{
+		if (!Volume.bAxisAligned || !Volume.Overlaps(Box))
+			continue;
+
+		for (int32 Axis = 0; Axis < 3 && SplitAxis == INDEX_NONE; Axis++)
+		{
+			for (const double Face : { Volume.Bounds.Min[Axis], Volume.Bounds.Max[Axis] })
+			{
+				if (Face > Box.Min[Axis] + UE_KINDA_SMALL_NUMBER && Face < Box.Max[Axis] - UE_KINDA_SMALL_NUMBER)
+				{
+					SplitAxis = Axis;
+					SplitValue = Face;
+					break;
+				}
+			}
+		}
+		if (SplitAxis != INDEX_NONE)
+			break;
+	}
+	if (SplitAxis == INDEX_NONE)
+	{
+		const FVector Size = Box.GetSize();
+		SplitAxis = Size.X >= Size.Y && Size.X >= Size.Z ? 0 : (Size.Y >= Size.Z ? 1 : 2);
+		SplitValue = Box.GetCenter()[SplitAxis];
+	}
+
+	FBox Lower = Box;
+	FBox Upper = Box;
+	Lower.Max[SplitAxis] = SplitValue;
+	Upper.Min[SplitAxis] = SplitValue;
+	return IsCoveredByVolumes(Lower, CoverageVolumes, Depth + 1) && IsCoveredByVolumes(Upper, CoverageVolumes, Depth + 1);
 }
 
 bool URegion::IsChildRegion(FGameplayTag InRegionTag) const
@@ -196,8 +313,7 @@ URegion* URegion::GetParentRegion() const
 	if (!RegionSubsystem)
 		return nullptr;
 	
-	FGameplayTag ParentTag = UGameplayTagExtensions::RemoveTagDepth(RegionTag);
-	return RegionSubsystem->GetRegionByTag(ParentTag);
+	return RegionSubsystem->GetParentRegion(RegionTag);
 }
 
 FGameplayTag URegion::GetParentRegionTag() const
@@ -215,18 +331,7 @@ TSet<URegion*> URegion::GetChildRegions() const
 	if (!RegionSubsystem)
 		return {};
 
-	TSet<URegion*> ChildRegions {};
-	for (auto Region : RegionSubsystem->GetAllRegions())
-	{
-		if (!Region || Region == this)
-			continue;
-		
-		if (Region->GetRegionTag().MatchesTag(GetRegionTag()))
-		{
-			ChildRegions.Add(Region);
-		}
-	}
-	return ChildRegions;
+	return RegionSubsystem->GetChildRegions(RegionTag);
 }
 
 FGameplayTagContainer URegion::GetChildRegionTags() const
@@ -244,23 +349,73 @@ FGameplayTagContainer URegion::GetChildRegionTags() const
 
 URegionModule* URegion::GetRegionModule(TSubclassOf<URegionModule> ModuleClass, bool AllowParentSearch) const
 {
-	const URegion* RegionToSearch = this;
-	do
+	if (!ModuleClass)
+		return nullptr;
+
+	auto& Cache = AllowParentSearch ? InheritedModuleCache : OwnModuleCache;
+	if (const TWeakObjectPtr<URegionModule>* CachedModule = Cache.Find(ModuleClass.Get()))
+		return CachedModule->Get();
+
+	URegionModule* FoundModule = FindOwnRegionModule(ModuleClass);
+	if (!FoundModule && AllowParentSearch)
+		FoundModule = GetParentRegionModule(ModuleClass, true);
+
+	Cache.Add(ModuleClass.Get(), FoundModule);
+	return FoundModule;
+}
+
+URegionModule* URegion::GetParentRegionModule(TSubclassOf<URegionModule> ModuleClass, bool AllowParentSearch) const
+{
+	if (!ModuleClass)
+		return nullptr;
+
+	if (!AllowParentSearch)
+	{
+		const URegion* ParentRegion = GetParentRegion();
+		return ParentRegion ? ParentRegion->GetRegionModule(ModuleClass, false) : nullptr;
+	}
+
+	if (const TWeakObjectPtr<URegionModule>* CachedModule = AncestorModuleCache.Find(ModuleClass.Get()))
+		return CachedModule->Get();
+
+	const URegion* ParentRegion = GetParentRegion();
+	URegionModule* FoundModule = ParentRegion ? ParentRegion->GetRegionModule(ModuleClass, true) : nullptr;
+
+	AncestorModuleCache.Add(ModuleClass.Get(), FoundModule);
+	return FoundModule;
+}
+
+URegionModule* URegion::FindOwnRegionModule(TSubclassOf<URegionModule> ModuleClass) const
+{
+	for (auto RegionModule : RegionModules)
 	{
-		for (auto RegionModule : RegionModules)
+		if (RegionModule.IsA(ModuleClass))
 		{
-			if (RegionModule.IsA(ModuleClass))
-			{
-				return RegionModule;
-			}
+			return RegionModule;
 		}
-		RegionToSearch = RegionToSearch->GetParentRegion();
 	}
-	while (RegionToSearch && AllowParentSearch);
-	
 	return nullptr;
 }
 
+void URegion::InvalidateModuleCache() const
+{
+	OwnModuleCache.Reset();
+	InvalidateInheritedModuleCache();
+
+	//Child regions may have resolved their modules through this region
+	for (URegion* ChildRegion : GetChildRegions())
+	{
+		if (ChildRegion)
+			ChildRegion->InvalidateInheritedModuleCache();
+	}
+}
+
+void URegion::InvalidateInheritedModuleCache() const
+{
+	InheritedModuleCache.Reset();
+	AncestorModuleCache.Reset();
+}
+
 bool URegion::TryEnterRegion(URegionTracker* Tracker, const ARegionVolume* Volume)
 {
 	FContainedTrackers* FoundTrackers = Volumes.Find(Volume);
@@ -11,7 +11,13 @@
 #include "Settings/RegionSettings.h"
 
 #if	WITH_EDITOR
+#include "Async/ParallelFor.h"
 #include "Components/BoxComponent.h"
+#include "Misc/ScopedSlowTask.h"
+#include "Misc/ScopeExit.h"
+#include "NavigationSystem.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "POI/RegionPOI.h"
 #endif
 
 URegionSubsystem* URegionSubsystem::Get(const UObject* WorldContextObject)
@@ -199,14 +205,55 @@ TSet<ARegionVolume*> URegionSubsystem::GetAllRegionVolumes() const
 	return Volumes;
 }
 
+TSet<URegion*> URegionSubsystem::GetChildRegions(FGameplayTag RegionTag) const
+{
+	TArray<URegion*> Descendants;
+	if (RegionTree.Contains(RegionTag))
+	{
+		RegionTree.GetDescendants(RegionTag, Descendants);
+	}
+	else
+	{
+		//Not a live region, the descendants hang below its closest ancestor or the roots
+		const TSharedPtr<FGameplayTagTreeNode<URegion*>> AncestorNode = RegionTree.FindClosestAncestor(RegionTag);
+		const TArray<TSharedPtr<FGameplayTagTreeNode<URegion*>>>& Siblings = AncestorNode ? AncestorNode->Children : RegionTree.GetRootNodes();
+		for (const auto& Sibling : Siblings)
+		{
+			if (!Sibling->Tag.MatchesTag(RegionTag))
+				continue;
+
+			Descendants.Add(Sibling->Value);
+			RegionTree.GetDescendants(Sibling->Tag, Descendants);
+		}
+	}
+	return TSet<URegion*>(Descendants);
+}
+
+URegion* URegionSubsystem::GetParentRegion(FGameplayTag RegionTag) const
+{
+	if (!RegionTag.IsValid())
+		return nullptr;
+
+	if (RegionTree.Contains(RegionTag))
+	{
+		const TSharedPtr<FGameplayTagTreeNode<URegion*>> ParentNode = RegionTree.GetParent(RegionTag);
+		return ParentNode ? ParentNode->Value : nullptr;
+	}
+
+	const TSharedPtr<FGameplayTagTreeNode<URegion*>> AncestorNode = RegionTree.FindClosestAncestor(RegionTag);
+	return AncestorNode ? AncestorNode->Value : nullptr;
+}
+
 URegion* URegionSubsystem::CreateNewRegion(FGameplayTag RegionTag)
 {
 	URegion* Region = NewObject<URegion>(this);
 	Region->RegionTag = RegionTag;
 
-	URegion* ParentRegion = Region->GetParentRegion();
-	TSet<URegion*> ChildRegions = Region->GetChildRegions();
 	RegionMap.Add(RegionTag, Region);
+	RegionTree.Insert(RegionTag, Region);
+	MarkRegionsChanged();
+	URegion* ParentRegion = GetParentRegion(RegionTag);
+	TSet<URegion*> ChildRegions = GetChildRegions(RegionTag);
 
 	CreateRegionModules(Region);
 
@@ -227,6 +274,7 @@ void URegionSubsystem::CreateRegionModules(URegion* Region)
 	//Create Modules
 	for (auto ModuleClass : URegionSettings::Get()->ImplementedModuleClasses)
 		Region->RegionModules.Add(NewObject<URegionModule>(Region, ModuleClass));
+	Region->InvalidateModuleCache();
 
 	//Start Modules
 	for (auto Module : Region->RegionModules)
@@ -246,9 +294,11 @@ void URegionSubsystem::DestroyRegion(URegion* Region)
 	for (auto Volume : Region->Volumes)
 		Volume.Key->bRegistered = false;
 
-	OnRegionAdded.Broadcast(Region);
+	OnRegionRemoved.Broadcast(Region);
 	Region->EndRegion();
 	RegionMap.Remove(Region->GetRegionTag());
+	RegionTree.Remove(Region->GetRegionTag());
+	MarkRegionsChanged();
 	Region->MarkAsGarbage();
 }
 
@@ -264,6 +314,7 @@ void URegionSubsystem::RegisterVolume(ARegionVolume* Volume)
 		Region = CreateNewRegion(RegionTag);
 
 	Region->AddVolume(Volume);
+	MarkRegionsChanged();
 }
 
 void URegionSubsystem::DeregisterVolume(ARegionVolume* Volume)
@@ -275,11 +326,19 @@ void URegionSubsystem::DeregisterVolume(ARegionVolume* Volume)
 	
 	TObjectPtr<URegion> Region = *RegionPtr;
 	Region->RemoveVolume(Volume);
+	MarkRegionsChanged();
 
 	if (Region->Volumes.Num()<=0)
 		DestroyRegion(Region);
 }
 
+void URegionSubsystem::VolumeChanged(ARegionVolume* Volume)
+{
+	const TObjectPtr<URegion>* RegionPtr = Volume ? RegionMap.Find(Volume->GetRegionTag()) : nullptr;
+	if (RegionPtr && (*RegionPtr)->Volumes.Contains(Volume))
+		MarkRegionsChanged();
+}
+
 bool URegionSubsystem::EnterRegionVolume(URegionTracker* Tracker, const ARegionVolume* Volume) const
 {
 	if (!Volume || !Tracker)
@@ -308,16 +367,9 @@ URegion* URegionSubsystem::GetRegionByTag(FGameplayTag RegionTag, bool AllowPare
 {
 	if (!RegionTag.IsValid())
 		return nullptr;
-    
-	FGameplayTag ParentTag = RegionTag;
-	do 
-	{
-		if (RegionMap.Contains(ParentTag))
-			return RegionMap[ParentTag];
-		ParentTag = UGameplayTagExtensions::RemoveTagDepth(ParentTag);
-	} while (ParentTag.IsValid() && AllowParents);
-        
-	return nullptr;
+
+	URegion* const* Region = AllowParents ? RegionTree.FindClosest(RegionTag) : RegionTree.Find(RegionTag);
+	return Region ? *Region : nullptr;
 }
 
 URegion* URegionSubsystem::GetRegionByLocation(FVector Location, ERegionTypes DesiredType) const
@@ -381,6 +433,104 @@ FGameplayTag URegionSubsystem::GetRegionTagByLocation(FVector Location, ERegionT
 	return FallbackTag;
 }
 
+void URegionSubsystem::GetRegionTagsByLocations(TConstArrayView<FVector> Locations, TArray<FGameplayTag>& OutTags, ERegionTypes DesiredType) const
+{
+	OutTags.SetNum(Locations.Num());
+	if (Locations.Num() <= 0)
+		return;
+
+	const TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> Snapshot = GetQuerySnapshot();
+	const int32 NumFallbacks = Snapshot->GetRegionTagsByLocations(Locations, OutTags, DesiredType);
+	if (NumFallbacks > 0)
+	{
+		UE_LOG(LogRegions, Warning, TEXT("No matching region of type [%s] found for %d of %d locations. Returned most detailed available tags."),
+			*UEnum::GetValueAsString(DesiredType), NumFallbacks, Locations.Num());
+	}
+}
+
+void URegionSubsystem::GetRegionVolumesByLocation(FVector Location, TArray<ARegionVolume*>& OutVolumes) const
+{
+	const TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> Snapshot = GetQuerySnapshot();
+
+	TArray<int32, TInlineAllocator<8>> VolumeIndices;
+	Snapshot->GetVolumesByLocation(Location, VolumeIndices);
+	for (const int32 VolumeIndex : VolumeIndices)
+	{
+		if (ARegionVolume* Volume = Snapshot->GetVolumes()[VolumeIndex].Actor.Get())
+			OutVolumes.Add(Volume);
+	}
+}
+
+TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> URegionSubsystem::GetQuerySnapshot() const
+{
+	//Outdated snapshots are rebuilt right away on the game thread, other threads get the last published one
+	if (IsInGameThread() && !IsSnapshotCurrent(*PublishedSnapshot))
+		PublishQuerySnapshot();
+
+	FScopeLock Lock(&SnapshotLock);
+	return PublishedSnapshot;
+}
+
+bool URegionSubsystem::IsSnapshotCurrent(const FRegionQuerySnapshot& Snapshot) const
+{
+	return Snapshot.GetVersion() == GetRegionVersion();
+}
+
+TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> URegionSubsystem::CreateQuerySnapshot() const
+{
+	check(IsInGameThread());
+
+	TSharedRef<FRegionQuerySnapshot, ESPMode::ThreadSafe> Snapshot = MakeShared<FRegionQuerySnapshot, ESPMode::ThreadSafe>(GetRegionVersion());
+	for (auto RegionPair : RegionMap)
+	{
+		const TSharedPtr<FGameplayTagTreeNode<URegion*>> ParentNode = RegionTree.GetParent(RegionPair.Key);
+		Snapshot->AddRegion(RegionPair.Key, ParentNode ? ParentNode->Tag : FGameplayTag());
+		for (auto Volume : RegionPair.Value->GetRegionVolumes())
+		{
+			//Volumes without a tag never contain anything, see ARegionVolume::Contains
+			if (!Volume || !Volume->RegionTag.IsValid())
+				continue;
+
+			Snapshot->AddVolume(Volume->RegionBox->GetComponentTransform(), Volume->RegionBox->GetUnscaledBoxExtent(), Volume);
+		}
+	}
+	Snapshot->Finalize();
+	return Snapshot;
+}
+
+void URegionSubsystem::PublishQuerySnapshot() const
+{
+	TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> Snapshot = CreateQuerySnapshot();
+
+	FScopeLock Lock(&SnapshotLock);
+	PublishedSnapshot = Snapshot;
+}
+
+void URegionSubsystem::MarkRegionsChanged()
+{
+	RegionVersion.fetch_add(1, std::memory_order_release);
+
+	//Volumes register one by one while loading, so the snapshot is published once on the next tick
+	if (!PublishTickerHandle.IsValid())
+	{
+		PublishTickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateWeakLambda(this, [this](float)
+		{
+			PublishTickerHandle.Reset();
+			if (!IsSnapshotCurrent(*PublishedSnapshot))
+				PublishQuerySnapshot();
+			return false;
+		}));
+	}
+}
+
+void URegionSubsystem::Deinitialize()
+{
+	FTSTicker::GetCoreTicker().RemoveTicker(PublishTickerHandle);
+	PublishTickerHandle.Reset();
+
+	Super::Deinitialize();
+}
+
 FGameplayTag URegionSubsystem::GetRegionTagByVolume(const FVector Location, const FVector BoxExtent, ERegionTypes DesiredType) const
 {
 	FGameplayTagContainer ContainedRegionTags;
@@ -499,13 +649,24 @@ void URegionSubsystem::HighlightRegion(FGameplayTag Region, bool bHideChildren)
 
 void URegionSubsystem::BakeRegions()
 {
+	BakeNavigationHashes.Emplace();
+	ON_SCOPE_EXIT { BakeNavigationHashes.Reset(); };
+
+	if (URegionSettings::Get()->bParallelBake)
+	{
+		BakeRegionsParallel();
+		return;
+	}
+
+	FPOICacheStats CacheStats;
 	for (auto Pair : RegionMap)
 	{
 		if (!Pair.Value)
 			continue;
 		
-		BakeRegion(Pair.Value);
+		BakeRegion(Pair.Value, &CacheStats);
 	}
+	ReportBakeCacheStats(CacheStats);
 }
 
 void URegionSubsystem::BakeRegion(FGameplayTag RegionTag)
@@ -517,6 +678,8 @@ void URegionSubsystem::BakeRegion(FGameplayTag RegionTag)
 		return;
 	}
 
+	BakeNavigationHashes.Emplace();
+	ON_SCOPE_EXIT { BakeNavigationHashes.Reset(); };
 	BakeRegion(Region);
 }
 
@@ -537,17 +700,241 @@ void URegionSubsystem::ForceRefreshRegions()
 	// }
 }
 
-void URegionSubsystem::BakeRegion(URegion* Region)
+bool URegionSubsystem::BakeRegionsParallel()
 {
+	if (RegionMap.Num() <= 0 || !GetWorld())
+		return true;
+
+	//Same POI order as the serial bake
+	TArray<ARegionPOI*> POIs;
+	TArray<FVector> Locations;
+	for (TActorIterator<ARegionPOI> It(GetWorld()); It; ++It)
+	{
+		if (!*It)
+			continue;
+
+		POIs.Add(*It);
+		Locations.Add(It->GetActorLocation());
+	}
+
+	constexpr int32 ChunkSize = 256;
+	const int32 NumChunks = FMath::DivideAndRoundUp(Locations.Num(), ChunkSize);
+	const int32 ChunksPerStep = FMath::Max(1, FTaskGraphInterface::Get().GetNumWorkerThreads());
+
+	FScopedSlowTask SlowTask(NumChunks + POIs.Num() + 1, NSLOCTEXT("RegionSubsystem", "BakeRegions", "Baking Regions"));
+	SlowTask.MakeDialog(true);
+
+	//Read only phase, the region of every POI is looked up on worker threads
+	const TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> Snapshot = GetQuerySnapshot();
+	TArray<FGameplayTag> RegionTags;
+	RegionTags.SetNum(Locations.Num());
+	for (int32 FirstChunk = 0; FirstChunk < NumChunks; FirstChunk += ChunksPerStep)
+	{
+		if (SlowTask.ShouldCancel())
+		{
+			UE_LOG(LogRegions, Log, TEXT("Region bake cancelled, no regions were changed."));
+			return false;
+		}
+
+		const int32 NumStepChunks = FMath::Min(ChunksPerStep, NumChunks - FirstChunk);
+		ParallelFor(NumStepChunks, [&](int32 StepChunk)
+		{
+			const int32 Start = (FirstChunk + StepChunk) * ChunkSize;
+			const int32 Count = FMath::Min(ChunkSize, Locations.Num() - Start);
+			Snapshot->GetRegionTagsByLocations(TConstArrayView<FVector>(Locations).Slice(Start, Count), TArrayView<FGameplayTag>(RegionTags).Slice(Start, Count), ERegionTypes::Room);
+		});
+		SlowTask.EnterProgressFrame(NumStepChunks);
+	}
+
+	//Hash the inputs of every POI in a region, only the outdated ones are recalculated
+	FPOICacheStats CacheStats;
+	TArray<uint32> InputHashes;
+	InputHashes.Init(0, POIs.Num());
+	TArray<int32> ParallelMisses;
+	TArray<int32> GameThreadMisses;
+	for (int32 Index = 0; Index < POIs.Num(); Index++)
+	{
+		if (!RegionMap.Contains(RegionTags[Index]) || !POIs[Index]->HasProcessor())
+			continue;
+
+		InputHashes[Index] = POIs[Index]->CalculateInputHash(RegionTags[Index]);
+		if (POIs[Index]->IsCalculationCurrent(InputHashes[Index]))
+		{
+			CacheStats.Hits++;
+			continue;
+		}
+
+		CacheStats.Misses++;
+		(POIs[Index]->CanCalculateInParallel() ? ParallelMisses : GameThreadMisses).Add(Index);
+	}
+	SlowTask.EnterProgressFrame(POIs.Num() - ParallelMisses.Num() - GameThreadMisses.Num());
+
+	//Native processors only trace and project onto the navigation, which is not rebuilt while the game thread waits here
+	TArray<FLocationCache> CalculatedPoints;
+	CalculatedPoints.SetNum(POIs.Num());
+	for (int32 FirstMiss = 0; FirstMiss < ParallelMisses.Num(); FirstMiss += ChunksPerStep)
+	{
+		if (SlowTask.ShouldCancel())
+		{
+			UE_LOG(LogRegions, Log, TEXT("Region bake cancelled, no regions were changed."));
+			return false;
+		}
+
+		const int32 NumStepMisses = FMath::Min(ChunksPerStep, ParallelMisses.Num() - FirstMiss);
+		ParallelFor(NumStepMisses, [&](int32 StepMiss)
+		{
+			const int32 Index = ParallelMisses[FirstMiss + StepMiss];
+			CalculatedPoints[Index] = POIs[Index]->CalculateRelevantPoints();
+		});
+		SlowTask.EnterProgressFrame(NumStepMisses);
+	}
+
+	//Blueprint and EQS processors have to run on the game thread
+	for (const int32 Index : GameThreadMisses)
+	{
+		if (SlowTask.ShouldCancel())
+		{
+			UE_LOG(LogRegions, Log, TEXT("Region bake cancelled, no regions were changed."));
+			return false;
+		}
+
+		CalculatedPoints[Index] = POIs[Index]->CalculateRelevantPoints();
+		SlowTask.EnterProgressFrame(1);
+	}
+
+	//Merge on the game thread once nothing can be cancelled anymore
+	TMap<FGameplayTag, TArray<FRegionPOIData>> POIDataByRegion;
+	for (int32 Index = 0; Index < POIs.Num(); Index++)
+	{
+		POIs[Index]->SetContainingRegion(RegionTags[Index]);
+		if (!RegionMap.Contains(RegionTags[Index]))
+			continue;
+
+		if (InputHashes[Index] != 0 && !POIs[Index]->IsCalculationCurrent(InputHashes[Index]))
+			POIs[Index]->ApplyRelevantPoints(MoveTemp(CalculatedPoints[Index]), InputHashes[Index]);
+		POIDataByRegion.FindOrAdd(RegionTags[Index]).Add(POIs[Index]->GetData());
+	}
+
+	for (auto Pair : RegionMap)
+	{
+		if (!Pair.Value)
+			continue;
+
+		const TArray<FRegionPOIData>* RegionPOIData = POIDataByRegion.Find(Pair.Key);
+		TArray<ARegionVolume*> Volumes = Pair.Value->GetRegionVolumes();
+		for (auto Volume : Volumes)
+		{
+			Volume->SetBakedPOIData(RegionPOIData ? TArray<FRegionPOIData>(*RegionPOIData) : TArray<FRegionPOIData>());
+		}
+
+		if (Volumes.Num() <= 0)
+		{
+			UE_LOG(LogRegions, Log, TEXT("Found No Volumes with requested tag!"))
+		}
+	}
+	ReportBakeCacheStats(CacheStats);
+	SlowTask.EnterProgressFrame(1);
+	return true;
+}
+
+void URegionSubsystem::BakeRegion(URegion* Region, FPOICacheStats* CacheStats)
+{
+	FPOICacheStats RegionCacheStats;
 	TArray<ARegionVolume*> Volumes = Region->GetRegionVolumes();
+	//Every volume of the region collects the same POIs, so each POI is only recalculated and counted once
+	TOptional<TArray<FRegionPOIData>> RegionPOIData;
 	for (auto Volume : Volumes)
 	{
-		Volume->Bake();
+		if (!RegionPOIData)
+		{
+			RegionPOIData = Volume->Bake(CacheStats ? CacheStats : &RegionCacheStats);
+		}
+		else
+		{
+			Volume->SetBakedPOIData(TArray<FRegionPOIData>(*RegionPOIData));
+		}
 	}
 
 	if (Volumes.Num() <= 0)
 	{
 		UE_LOG(LogRegions, Log, TEXT("Found No Volumes with requested tag!"))
 	}
+
+	if (!CacheStats)
+		ReportBakeCacheStats(RegionCacheStats);
+}
+
+void URegionSubsystem::ReportBakeCacheStats(const FPOICacheStats& CacheStats)
+{
+	LastBakeCacheHits = CacheStats.Hits;
+	LastBakeCacheMisses = CacheStats.Misses;
+	UE_LOG(LogRegions, Log, TEXT("POI cache: %d hits, %d misses"), CacheStats.Hits, CacheStats.Misses);
+}
+
+uint32 URegionSubsystem::GetNavigationHash(const FGameplayTag& RegionTag)
+{
+	if (BakeNavigationHashes)
+	{
+		if (const uint32* Hash = BakeNavigationHashes->Find(RegionTag))
+			return *Hash;
+	}
+
+	FBox Bounds(ForceInit);
+	if (URegion* Region = GetRegionByTag(RegionTag, false))
+	{
+		for (const ARegionVolume* Volume : Region->GetRegionVolumes())
+		{
+			if (!Volume)
+				continue;
+
+			const FVector Extent = Volume->GetUnscaledBoxExtent();
+			Bounds += FBox(-Extent, Extent).TransformBy(Volume->GetBoxTransform());
+		}
+	}
+
+	const uint32 Hash = CalculateNavigationHash(Bounds);
+	if (BakeNavigationHashes)
+		BakeNavigationHashes->Add(RegionTag, Hash);
+	return Hash;
+}
+
+uint32 URegionSubsystem::CalculateNavigationHash(const FBox& Bounds) const
+{
+	uint32 Hash = 0;
+#if WITH_RECAST
+	if (!Bounds.IsValid || !GetWorld())
+		return Hash;
+
+	//Polygon centers are stored with the navmesh, so the hash survives editor restarts and only changes with the tiles in the bounds
+	for (TActorIterator<ARecastNavMesh> It(GetWorld()); It; ++It)
+	{
+		TArray<int32> TileIndices;
+		It->GetNavMeshTilesIn({ Bounds }, TileIndices);
+
+		//Tile indices depend on the order the tiles were added, so the tiles are hashed by content
+		TArray<uint32> TileHashes;
+		for (const int32 TileIndex : TileIndices)
+		{
+			TArray<FNavPoly> Polys;
+			if (!It->GetPolysInTile(TileIndex, Polys))
+				continue;
+
+			uint32 TileHash = GetTypeHash(Polys.Num());
+			for (const FNavPoly& Poly : Polys)
+			{
+				TileHash = HashCombine(TileHash, GetTypeHash(Poly.Center));
+			}
+			TileHashes.Add(TileHash);
+		}
+		TileHashes.Sort();
+
+		Hash = HashCombine(Hash, GetTypeHash(It->GetName()));
+		for (const uint32 TileHash : TileHashes)
+		{
+			Hash = HashCombine(Hash, TileHash);
+		}
+	}
+#endif
+	return Hash;
 }
 #endif
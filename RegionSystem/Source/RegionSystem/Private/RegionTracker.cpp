@@ -6,8 +6,11 @@
 #include "RegionSystem.h"
 #include "RegionTags.h"
 #include "RegionVolume.h"
+#include "Settings/RegionSettings.h"
 #include "Extensions/GameplayTagExtensions.h"
 #include "GameFramework/Character.h"
+#include "GameFramework/GameStateBase.h"
+#include "ReplicatedObject/GlobalReplicator.h"
 
 void URegionTracker::ForceSetRegion_Implementation(FGameplayTag NewRegion)
 {
@@ -30,6 +33,29 @@ void URegionTracker::GetCheckData_Implementation(FVector& CheckLocation, ERegion
 	bDisableRuntimeChecks = false;
 }
 
+bool URegionTracker::IsRelevantForTag_Implementation(FGameplayTag RelevancyTag) const
+{
+	if (IsInRegion(RelevancyTag))
+		return true;
+
+	const FGameplayTagContainer* Neighbors = URegionSettings::Get()->RelevancyNeighbors.Find(RelevancyTag);
+	if (!Neighbors)
+		return false;
+
+	for (const FGameplayTag& Neighbor : *Neighbors)
+	{
+		if (IsInRegion(Neighbor))
+			return true;
+	}
+	return false;
+}
+
+URegionTracker::URegionTracker()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
 void URegionTracker::BeginPlay()
 {
 	Super::BeginPlay();
@@ -39,26 +65,79 @@ void URegionTracker::BeginPlay()
 	{
 		CachedRegionTag = RegionSubsystem->GetRegionTagByTracker(this);
 	}
+
+	if (URegionSettings::UsePointTracking())
+	{
+		SetComponentTickInterval(URegionSettings::Get()->PointQueryInterval);
+		SetComponentTickEnabled(true);
+		UpdatePointTracking();
+	}
 }
 
-bool URegionTracker::IsInRegion(FGameplayTag Tag) const
+void URegionTracker::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
-	for (auto Region : GetRegionTags())
+	//Leave point tracked volumes the same way an ending overlap would
+	if (URegionSubsystem* RegionSubsystem = URegionSubsystem::Get(this))
 	{
-		if (Region.MatchesTag(Tag))
-			return true;
+		for (const TWeakObjectPtr<ARegionVolume>& Volume : PointTrackedVolumes)
+		{
+			if (Volume.IsValid())
+				RegionSubsystem->ExitRegionVolume(this, Volume.Get());
+		}
 	}
-	return false;
+	PointTrackedVolumes.Empty();
+
+	Super::EndPlay(EndPlayReason);
 }
 
-FGameplayTagContainer URegionTracker::GetRegionTags() const
+void URegionTracker::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdatePointTracking();
+}
+
+void URegionTracker::UpdatePointTracking()
 {
-	FGameplayTagContainer Regions;
-	for (auto RegionRef : RegionRefs)
+	URegionSubsystem* RegionSubsystem = URegionSubsystem::Get(this);
+	if (!RegionSubsystem || !GetOwner())
+		return;
+
+	//Membership only depends on the current location, so teleports are handled like any other move
+	TArray<ARegionVolume*> Volumes;
+	RegionSubsystem->GetRegionVolumesByLocation(GetOwner()->GetActorLocation(), Volumes);
+
+	//Exits first, like overlaps ending before new ones begin
+	for (int32 Index = PointTrackedVolumes.Num() - 1; Index >= 0; Index--)
 	{
-		Regions.AddTag(RegionRef->GetRegionTag());
+		ARegionVolume* Volume = PointTrackedVolumes[Index].Get();
+		if (Volume && Volumes.Contains(Volume))
+			continue;
+
+		PointTrackedVolumes.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		if (Volume)
+			RegionSubsystem->ExitRegionVolume(this, Volume);
+	}
+
+	for (ARegionVolume* Volume : Volumes)
+	{
+		if (PointTrackedVolumes.Contains(Volume))
+			continue;
+
+		PointTrackedVolumes.Add(Volume);
+		RegionSubsystem->EnterRegionVolume(this, Volume);
 	}
-	return Regions;
+}
+
+bool URegionTracker::IsInRegion(FGameplayTag Tag) const
+{
+	//Parent tags are part of the container, so this matches the tag or any of its children
+	return CachedRegionTags.HasTag(Tag);
+}
+
+FGameplayTagContainer URegionTracker::GetRegionTags() const
+{
+	return CachedRegionTags;
 }
 
 FGameplayTag URegionTracker::GetContainingRegionTag() const
@@ -105,55 +184,107 @@ bool URegionTracker::IsInValidRegion() const
 
 void URegionTracker::AddRegion(URegion* Region)
 {
-	const FGameplayTag RegionTag = Region->GetRegionTag();
-	bool bShouldTrigger = !IsInRegion(RegionTag);
-	
+	BeginRegionChange();
+
 	RegionRefs.Add(Region);
+	CachedRegionTags.AddTag(Region->GetRegionTag());
+	//Queries see the new region right away, only the broadcast waits when coalescing
+	CachedRegionTag = FGameplayTag();
+	PendingChangedTags.AddTag(Region->GetRegionTag());
 
-	if (bShouldTrigger)
-	{
-		OnRegionEnter.Broadcast(RegionTag);
-		DEBUG_SIMPLE(LogRegions, Log, FColor::Green, FString::Printf(TEXT("Entered %s"), *RegionTag.GetTagName().ToString()), RegionTags::Name);
-	}
-	else
+	if (!bCoalesceRegionChanges)
+		FlushRegionChange();
+}
+
+void URegionTracker::RemoveRegion(URegion* Region)
+{
+	BeginRegionChange();
+
+	RegionRefs.Remove(Region);
+	CachedRegionTags.RemoveTag(Region->GetRegionTag());
+	CachedRegionTag = FGameplayTag();
+	PendingChangedTags.AddTag(Region->GetRegionTag());
+
+	if (!bCoalesceRegionChanges)
+		FlushRegionChange();
+}
+
+void URegionTracker::BeginRegionChange()
+{
+	if (bRegionChangePending)
+		return;
+
+	bRegionChangePending = true;
+	PendingPreviousRegionTag = GetContainingRegionTag();
+	PendingPreviousRegionTags = CachedRegionTags;
+	PendingChangedTags.Reset();
+
+	if (bCoalesceRegionChanges && GetWorld())
 	{
-		DEBUG_SIMPLE(LogRegions, Log, FColor::White, FString::Printf(TEXT("Quietly Entered %s"), *RegionTag.GetTagName().ToString()), RegionTags::Name);
+		GetWorld()->GetTimerManager().SetTimerForNextTick(this, &URegionTracker::FlushRegionChange);
 	}
+}
 
-	const FGameplayTag PreviousRegionTag = CachedRegionTag;
-	CachedRegionTag = FGameplayTag();
-	
-	if (ACharacter* Character = Cast<ACharacter>(GetOwner()))
+void URegionTracker::FlushRegionChange()
+{
+	if (!bRegionChangePending)
+		return;
+	bRegionChangePending = false;
+
+	FRegionTrackerChange Change;
+	Change.PreviousRegionTag = PendingPreviousRegionTag;
+	Change.NewRegionTag = GetContainingRegionTag();
+
+	//A region counts as entered or exited only if no tracked region matched it before or after, like the single events
+	for (const FGameplayTag& RegionTag : PendingChangedTags)
 	{
-		if (APlayerState* PlayerState = Character->GetPlayerState())
+		const bool bWasInRegion = PendingPreviousRegionTags.HasTag(RegionTag);
+		const bool bIsInRegion = CachedRegionTags.HasTag(RegionTag);
+		if (!bWasInRegion && bIsInRegion)
 		{
-			if (UAbilitySystemComponent* AbilitySystemComponent = PlayerState->GetComponentByClass<UAbilitySystemComponent>())
-			{
-				AbilitySystemComponent->RemoveLooseGameplayTag(PreviousRegionTag);
-				AbilitySystemComponent->AddLooseGameplayTag(GetContainingRegionTag());
-			}
+			Change.EnteredTags.AddTag(RegionTag);
+			DEBUG_SIMPLE(LogRegions, Log, FColor::Green, FString::Printf(TEXT("Entered %s"), *RegionTag.GetTagName().ToString()), RegionTags::Name);
+		}
+		else if (bWasInRegion && !bIsInRegion)
+		{
+			Change.ExitedTags.AddTag(RegionTag);
+			DEBUG_SIMPLE(LogRegions, Log, FColor::Red, FString::Printf(TEXT("Exited %s"), *RegionTag.GetTagName().ToString()), RegionTags::Name);
+		}
+		else
+		{
+			DEBUG_SIMPLE(LogRegions, Log, FColor::White, FString::Printf(TEXT("Quietly Changed %s"), *RegionTag.GetTagName().ToString()), RegionTags::Name);
 		}
 	}
-}
+	PendingChangedTags.Reset();
+	PendingPreviousRegionTags.Reset();
 
-void URegionTracker::RemoveRegion(URegion* Region)
-{
-	RegionRefs.Remove(Region);
-	
-	const FGameplayTag RegionTag = Region->GetRegionTag();
-	if (!IsInRegion(RegionTag))
+	ApplyLooseRegionTag(Change.PreviousRegionTag, Change.NewRegionTag);
+
+	//Relevancy scoped replicated keys follow the regions of the owner
+	if ((Change.EnteredTags.Num() > 0 || Change.ExitedTags.Num() > 0) && GetOwner() && GetOwner()->HasAuthority())
 	{
-		OnRegionExit.Broadcast(RegionTag);
-		DEBUG_SIMPLE(LogRegions, Log, FColor::Red, FString::Printf(TEXT("Exited %s"), *RegionTag.GetTagName().ToString()), RegionTags::Name)
+		AGameStateBase* GameState = GetWorld() ? GetWorld()->GetGameState() : nullptr;
+		if (UGlobalReplicator* GlobalReplicator = GameState ? GameState->FindComponentByClass<UGlobalReplicator>() : nullptr)
+			GlobalReplicator->MarkRelevancyDirty(GetOwner());
 	}
-	else
+
+	if (!bCoalesceRegionChanges)
 	{
-		DEBUG_SIMPLE(LogRegions, Log, FColor::White, FString::Printf(TEXT("Quietly Exited %s"), *RegionTag.GetTagName().ToString()), RegionTags::Name)
+		for (const FGameplayTag& RegionTag : Change.EnteredTags)
+			OnRegionEnter.Broadcast(RegionTag);
+		for (const FGameplayTag& RegionTag : Change.ExitedTags)
+			OnRegionExit.Broadcast(RegionTag);
 	}
-	
-	const FGameplayTag PreviousRegionTag = CachedRegionTag;
-	CachedRegionTag = FGameplayTag();
-	
+
+	if (Change.EnteredTags.Num() > 0 || Change.ExitedTags.Num() > 0 || Change.PreviousRegionTag != Change.NewRegionTag)
+		OnRegionChanged.Broadcast(Change);
+}
+
+void URegionTracker::ApplyLooseRegionTag(FGameplayTag PreviousRegionTag, FGameplayTag NewRegionTag) const
+{
+	if (PreviousRegionTag == NewRegionTag)
+		return;
+
 	if (ACharacter* Character = Cast<ACharacter>(GetOwner()))
 	{
 		if (APlayerState* PlayerState = Character->GetPlayerState())
@@ -161,7 +292,7 @@ void URegionTracker::RemoveRegion(URegion* Region)
 			if (UAbilitySystemComponent* AbilitySystemComponent = PlayerState->GetComponentByClass<UAbilitySystemComponent>())
 			{
 				AbilitySystemComponent->RemoveLooseGameplayTag(PreviousRegionTag);
-				AbilitySystemComponent->AddLooseGameplayTag(GetContainingRegionTag());
+				AbilitySystemComponent->AddLooseGameplayTag(NewRegionTag);
 			}
 		}
 	}
@@ -169,5 +300,5 @@ void URegionTracker::RemoveRegion(URegion* Region)
 
 FGameplayTag URegionTracker::CalculateRelevantRegion() const
 {
-	return UGameplayTagExtensions::GetMostDetailedTag(GetRegionTags());
+	return UGameplayTagExtensions::GetMostDetailedTag(CachedRegionTags);
 }
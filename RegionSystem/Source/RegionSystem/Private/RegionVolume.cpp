@@ -132,11 +132,9 @@ void ARegionVolume::SetExtension()
 	}
 }
 
-void ARegionVolume::Bake()
+TArray<FRegionPOIData> ARegionVolume::Bake(FPOICacheStats* CacheStats)
 {
-	POIData.Empty();
-
-	TArray<ARegionPOI*> AllPOIs;
+	TArray<FRegionPOIData> NewPOIData;
 	for (TActorIterator<ARegionPOI> It(GetWorld()); It; ++It)
 	{
 		ARegionPOI* POI = *It;
@@ -148,10 +146,19 @@ void ARegionVolume::Bake()
 		POI->ReevaluateRegion();
 		if (POI->GetContainingRegion().MatchesTagExact(GetRegionTag()))
 		{
-			POIData.Add(POI->GetData());
+			POI->RecalculateIfChanged(CacheStats);
+			NewPOIData.Add(POI->GetData());
 		}
 	}
 
+	SetBakedPOIData(TArray<FRegionPOIData>(NewPOIData));
+	return NewPOIData;
+}
+
+void ARegionVolume::SetBakedPOIData(TArray<FRegionPOIData>&& InPOIData)
+{
+	POIData = MoveTemp(InPOIData);
+
 	//FallBack
 	if (POIData.Num() <= 0)
 	{
@@ -250,14 +257,24 @@ void ARegionVolume::BeginPlay()
 {
 	Super::BeginPlay();
 
-	RegionBox->OnComponentBeginOverlap.AddDynamic(this, &ARegionVolume::OnOverlapBegin);
-	RegionBox->OnComponentEndOverlap.AddDynamic(this, &ARegionVolume::OnOverlapEnd);
+	//Trackers query their regions themselves, so no overlaps are needed
+	if (URegionSettings::UsePointTracking())
+	{
+		RegionBox->SetGenerateOverlapEvents(false);
+	}
+	else
+	{
+		RegionBox->OnComponentBeginOverlap.AddDynamic(this, &ARegionVolume::OnOverlapBegin);
+		RegionBox->OnComponentEndOverlap.AddDynamic(this, &ARegionVolume::OnOverlapEnd);
+	}
+	RegionBox->TransformUpdated.AddUObject(this, &ARegionVolume::OnRegionBoxTransformUpdated);
 
 	RegisterSelfWithSubsystem();
 }
 
 void ARegionVolume::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	RegionBox->TransformUpdated.RemoveAll(this);
 	DeregisterSelfWithSubsystem();
 
 	Super::EndPlay(EndPlayReason);
@@ -337,7 +354,7 @@ TArray<AActor*> ARegionVolume::GetAllActorsInRegion() const
 	bool bForceBoxCheck = false;
 
 	if (const URegionSettings* Settings = URegionSettings::Get())
-		bForceBoxCheck = Settings->bForceVolumeBoxChecks;
+		bForceBoxCheck = Settings->bForceVolumeBoxChecks || Settings->TrackingMode == ERegionTrackingMode::PointQuery;
 
 #if WITH_EDITOR
 	if (GetWorld() && GetWorld()->WorldType == EWorldType::Editor)
@@ -437,6 +454,25 @@ bool ARegionVolume::ContainsFully(const FVector Location, const FVector BoxExten
 		(FMath::Abs(LocalCenter.Z) + LocalTestExtent.Z <= RegionBoxExtent.Z);
 }
 
+FTransform ARegionVolume::GetBoxTransform() const
+{
+	return RegionBox->GetComponentTransform();
+}
+
+FVector ARegionVolume::GetUnscaledBoxExtent() const
+{
+	return RegionBox->GetUnscaledBoxExtent();
+}
+
+void ARegionVolume::SetBoxExtent(const FVector InBoxExtent)
+{
+	if (RegionBox->GetUnscaledBoxExtent() == InBoxExtent)
+		return;
+
+	RegionBox->SetBoxExtent(InBoxExtent);
+	NotifyVolumeChanged();
+}
+
 TArray<FRegionPOIData> ARegionVolume::GetPOIData() const
 {
 	if (POIData.Num() <= 0)
@@ -492,6 +528,19 @@ void ARegionVolume::DeregisterSelfWithSubsystem()
 	}
 }
 
+void ARegionVolume::OnRegionBoxTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	NotifyVolumeChanged();
+}
+
+void ARegionVolume::NotifyVolumeChanged()
+{
+	if (URegionSubsystem* Subsystem = URegionSubsystem::Get(this))
+	{
+		Subsystem->VolumeChanged(this);
+	}
+}
+
 float ARegionVolume::GetTextScale() const
 {
 	return 2;
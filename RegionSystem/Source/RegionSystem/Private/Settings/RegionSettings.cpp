@@ -12,6 +12,13 @@ bool URegionSettings::GetDefaultModuleFuzeState()
 	return true;
 }
 
+bool URegionSettings::UsePointTracking()
+{
+	if (const URegionSettings* Defaults = Get())
+		return Defaults->TrackingMode == ERegionTrackingMode::PointQuery;
+	return false;
+}
+
 bool URegionSettings::IsTypeEnabledByDefault(EElectricityConsumerType ElectricityConsumer)
 {
 	if (const URegionSettings* Defaults = Get())
@@ -0,0 +1,255 @@
+﻿#include "Structs/RegionQuerySnapshot.h"
+#include "RegionFunctionLibrary.h"
+#include "Extensions/GameplayTagExtensions.h"
+
+//Bounds are widened so rounding can never reject a point the exact test accepts
+static constexpr double RegionBoundsTolerance = 1.0;
+
+void FRegionQuerySnapshot::AddRegion(FGameplayTag Tag, FGameplayTag ParentTag)
+{
+	RegionIndices.Add(Tag, Regions.Num());
+	PendingParentTags.Add(ParentTag);
+
+	FRegion& Region = Regions.AddDefaulted_GetRef();
+	Region.Tag = Tag;
+	Region.Type = URegionFunctionLibrary::GetRegionTypeByTag(Tag);
+	Region.TagDepth = UGameplayTagExtensions::GetTagDepth(Tag);
+	Region.FirstVolume = Volumes.Num();
+}
+
+void FRegionQuerySnapshot::AddVolume(const FTransform& Transform, const FVector& Extent, TWeakObjectPtr<ARegionVolume> Actor)
+{
+	check(Regions.Num() > 0);
+
+	FVolume& Volume = Volumes.AddDefaulted_GetRef();
+	Volume.Transform = Transform;
+	Volume.Extent = Extent;
+	Volume.Bounds = FBox(-Extent, Extent).TransformBy(Transform).ExpandBy(RegionBoundsTolerance);
+	Volume.Actor = Actor;
+
+	VolumeRegions.Add(Regions.Num() - 1);
+	Regions.Last().NumVolumes++;
+}
+
+void FRegionQuerySnapshot::Finalize()
+{
+	for (int32 RegionIndex = 0; RegionIndex < Regions.Num(); RegionIndex++)
+	{
+		if (const int32* ParentIndex = RegionIndices.Find(PendingParentTags[RegionIndex]))
+			Regions[RegionIndex].ParentIndex = *ParentIndex;
+	}
+	PendingParentTags.Empty();
+
+	BuildGrid();
+}
+
+void FRegionQuerySnapshot::BuildGrid()
+{
+	GridBounds = FBox(ForceInit);
+	for (const FVolume& Volume : Volumes)
+		GridBounds += Volume.Bounds;
+
+	GridCells = FIntVector::ZeroValue;
+	GridCellOffsets.Reset();
+	GridVolumes.Reset();
+	if (!GridBounds.IsValid)
+		return;
+
+	//Roughly a couple of volumes per cell along each axis
+	const int32 CellsPerAxis = FMath::Clamp(FMath::CeilToInt(2.0 * FMath::Pow(static_cast<double>(Volumes.Num()), 1.0 / 3.0)), 1, MaxGridCellsPerAxis);
+	GridCells = FIntVector(CellsPerAxis);
+	GridCellSize = GridBounds.GetSize() / CellsPerAxis;
+	GridCellSize = FVector(FMath::Max(GridCellSize.X, 1.0), FMath::Max(GridCellSize.Y, 1.0), FMath::Max(GridCellSize.Z, 1.0));
+
+	auto GetCellRange = [this](const FBox& Bounds, FIntVector& OutMin, FIntVector& OutMax)
+	{
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			OutMin[Axis] = FMath::Clamp(FMath::FloorToInt((Bounds.Min[Axis] - GridBounds.Min[Axis]) / GridCellSize[Axis]), 0, GridCells[Axis] - 1);
+			OutMax[Axis] = FMath::Clamp(FMath::FloorToInt((Bounds.Max[Axis] - GridBounds.Min[Axis]) / GridCellSize[Axis]), 0, GridCells[Axis] - 1);
+		}
+	};
+
+	//Counted first, then filled in volume order so every cell lists its volumes in ascending order
+	const int32 NumCells = GridCells.X * GridCells.Y * GridCells.Z;
+	TArray<int32> CellCounts;
+	CellCounts.SetNumZeroed(NumCells);
+	for (int32 Pass = 0; Pass < 2; Pass++)
+	{
+		if (Pass == 1)
+		{
+			GridCellOffsets.SetNumUninitialized(NumCells + 1);
+			GridCellOffsets[0] = 0;
+			for (int32 Cell = 0; Cell < NumCells; Cell++)
+				GridCellOffsets[Cell + 1] = GridCellOffsets[Cell] + CellCounts[Cell];
+
+			GridVolumes.SetNumUninitialized(GridCellOffsets[NumCells]);
+			FMemory::Memzero(CellCounts.GetData(), CellCounts.Num() * sizeof(int32));
+		}
+
+		for (int32 VolumeIndex = 0; VolumeIndex < Volumes.Num(); VolumeIndex++)
+		{
+			FIntVector Min, Max;
+			GetCellRange(Volumes[VolumeIndex].Bounds, Min, Max);
+			for (int32 Z = Min.Z; Z <= Max.Z; Z++)
+			{
+				for (int32 Y = Min.Y; Y <= Max.Y; Y++)
+				{
+					for (int32 X = Min.X; X <= Max.X; X++)
+					{
+						const int32 Cell = (Z * GridCells.Y + Y) * GridCells.X + X;
+						if (Pass == 1)
+							GridVolumes[GridCellOffsets[Cell] + CellCounts[Cell]] = VolumeIndex;
+						CellCounts[Cell]++;
+					}
+				}
+			}
+		}
+	}
+}
+
+TConstArrayView<int32> FRegionQuerySnapshot::GetCandidateVolumes(const FVector& Location) const
+{
+	if (GridCellOffsets.IsEmpty() || !GridBounds.IsInsideOrOn(Location))
+		return {};
+
+	FIntVector CellCoords;
+	for (int32 Axis = 0; Axis < 3; Axis++)
+		CellCoords[Axis] = FMath::Clamp(FMath::FloorToInt((Location[Axis] - GridBounds.Min[Axis]) / GridCellSize[Axis]), 0, GridCells[Axis] - 1);
+
+	const int32 Cell = (CellCoords.Z * GridCells.Y + CellCoords.Y) * GridCells.X + CellCoords.X;
+	return MakeArrayView(GridVolumes).Slice(GridCellOffsets[Cell], GridCellOffsets[Cell + 1] - GridCellOffsets[Cell]);
+}
+
+int32 FRegionQuerySnapshot::FindRegionIndex(FGameplayTag RegionTag) const
+{
+	const int32* RegionIndex = RegionIndices.Find(RegionTag);
+	return RegionIndex ? *RegionIndex : INDEX_NONE;
+}
+
+bool FRegionQuerySnapshot::Contains(FGameplayTag RegionTag, const FVector& Location) const
+{
+	const int32 RegionIndex = FindRegionIndex(RegionTag);
+	return RegionIndex != INDEX_NONE && Contains(RegionIndex, Location);
+}
+
+FGameplayTag FRegionQuerySnapshot::GetParentRegionTag(FGameplayTag RegionTag) const
+{
+	const int32 RegionIndex = FindRegionIndex(RegionTag);
+	if (RegionIndex == INDEX_NONE || Regions[RegionIndex].ParentIndex == INDEX_NONE)
+		return FGameplayTag();
+
+	return Regions[Regions[RegionIndex].ParentIndex].Tag;
+}
+
+void FRegionQuerySnapshot::GetChildRegionTags(FGameplayTag RegionTag, TArray<FGameplayTag>& OutTags, bool bRecursive) const
+{
+	const int32 ParentIndex = FindRegionIndex(RegionTag);
+	if (ParentIndex == INDEX_NONE)
+		return;
+
+	for (int32 RegionIndex = 0; RegionIndex < Regions.Num(); RegionIndex++)
+	{
+		const bool bChild = bRecursive ? IsChildRegionOf(RegionIndex, ParentIndex) : Regions[RegionIndex].ParentIndex == ParentIndex;
+		if (bChild)
+			OutTags.Add(Regions[RegionIndex].Tag);
+	}
+}
+
+bool FRegionQuerySnapshot::IsChildRegionOf(FGameplayTag RegionTag, FGameplayTag ParentTag) const
+{
+	const int32 RegionIndex = FindRegionIndex(RegionTag);
+	const int32 ParentIndex = FindRegionIndex(ParentTag);
+	return RegionIndex != INDEX_NONE && ParentIndex != INDEX_NONE && IsChildRegionOf(RegionIndex, ParentIndex);
+}
+
+bool FRegionQuerySnapshot::IsChildRegionOf(int32 RegionIndex, int32 ParentIndex) const
+{
+	for (int32 Index = Regions[RegionIndex].ParentIndex; Index != INDEX_NONE; Index = Regions[Index].ParentIndex)
+	{
+		if (Index == ParentIndex)
+			return true;
+	}
+	return false;
+}
+
+bool FRegionQuerySnapshot::Contains(int32 RegionIndex, const FVector& Location) const
+{
+	const FRegion& Region = Regions[RegionIndex];
+	for (int32 VolumeIndex = Region.FirstVolume; VolumeIndex < Region.FirstVolume + Region.NumVolumes; VolumeIndex++)
+	{
+		if (VolumeContains(VolumeIndex, Location))
+			return true;
+	}
+	return false;
+}
+
+bool FRegionQuerySnapshot::VolumeContains(int32 VolumeIndex, const FVector& Location) const
+{
+	const FVolume& Volume = Volumes[VolumeIndex];
+	if (!Volume.Bounds.IsInsideOrOn(Location))
+		return false;
+
+	//Same test as ARegionVolume::Contains
+	const FVector LocalPoint = Volume.Transform.InverseTransformPosition(Location);
+	return FMath::Abs(LocalPoint.X) <= Volume.Extent.X &&
+		FMath::Abs(LocalPoint.Y) <= Volume.Extent.Y &&
+		FMath::Abs(LocalPoint.Z) <= Volume.Extent.Z;
+}
+
+FGameplayTag FRegionQuerySnapshot::GetRegionTagByLocation(const FVector& Location, ERegionTypes DesiredType, bool* bOutUsedFallback) const
+{
+	int32 DesiredIndex = INDEX_NONE;
+	int32 DesiredDepth = 0;
+	int32 FallbackIndex = INDEX_NONE;
+	int32 FallbackDepth = 0;
+
+	//Volumes are stored by region, so the candidates visit the regions in order like the single query
+	for (const int32 VolumeIndex : GetCandidateVolumes(Location))
+	{
+		const int32 RegionIndex = VolumeRegions[VolumeIndex];
+		const FRegion& Region = Regions[RegionIndex];
+
+		//Only regions deeper than the current best can change the result
+		const bool bBetterDesired = Region.Type == DesiredType && Region.TagDepth > DesiredDepth;
+		const bool bBetterFallback = Region.TagDepth > FallbackDepth;
+		if (!bBetterDesired && !bBetterFallback)
+			continue;
+
+		if (!VolumeContains(VolumeIndex, Location))
+			continue;
+
+		if (bBetterDesired)
+		{
+			DesiredIndex = RegionIndex;
+			DesiredDepth = Region.TagDepth;
+		}
+		if (bBetterFallback)
+		{
+			FallbackIndex = RegionIndex;
+			FallbackDepth = Region.TagDepth;
+		}
+	}
+
+	if (bOutUsedFallback)
+		*bOutUsedFallback = DesiredIndex == INDEX_NONE;
+
+	if (DesiredIndex != INDEX_NONE)
+		return Regions[DesiredIndex].Tag;
+
+	return FallbackIndex != INDEX_NONE ? Regions[FallbackIndex].Tag : FGameplayTag();
+}
+
+int32 FRegionQuerySnapshot::GetRegionTagsByLocations(TConstArrayView<FVector> Locations, TArrayView<FGameplayTag> OutTags, ERegionTypes DesiredType) const
+{
+	check(Locations.Num() == OutTags.Num());
+
+	int32 NumFallbacks = 0;
+	for (int32 Index = 0; Index < Locations.Num(); Index++)
+	{
+		bool bUsedFallback = false;
+		OutTags[Index] = GetRegionTagByLocation(Locations[Index], DesiredType, &bUsedFallback);
+		NumFallbacks += bUsedFallback ? 1 : 0;
+	}
+	return NumFallbacks;
+}
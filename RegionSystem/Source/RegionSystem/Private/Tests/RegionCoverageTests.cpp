@@ -0,0 +1,86 @@
+﻿#include "Misc/AutomationTest.h"
+#include "Region.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+struct FRegionCoverageTestAccess
+{
+	using FVolume = URegion::FRegionCoverageVolume;
+
+	static FVolume MakeVolume(const FVector& Center, const FVector& Extent, const FRotator& Rotation = FRotator::ZeroRotator)
+	{
+		return FVolume(FTransform(Rotation, Center), Extent);
+	}
+
+	static bool IsCovered(const FVector& Center, const FVector& Extent, TConstArrayView<FVolume> Volumes)
+	{
+		return URegion::IsCoveredByVolumes(FBox(Center - Extent, Center + Extent), Volumes, 0);
+	}
+};
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRegionCoverageAdjacentTest, "RegionSystem.Region.Coverage.Adjacent", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRegionCoverageAdjacentTest::RunTest(const FString& Parameters)
+{
+	using FAccess = FRegionCoverageTestAccess;
+
+	//Two boxes sharing the face at X = 0
+	const FAccess::FVolume Volumes[] = {
+		FAccess::MakeVolume(FVector(-100, 0, 0), FVector(100)),
+		FAccess::MakeVolume(FVector(100, 0, 0), FVector(100))
+	};
+
+	TestTrue(TEXT("Box across the shared face is covered"), FAccess::IsCovered(FVector::ZeroVector, FVector(150, 50, 50), Volumes));
+	TestTrue(TEXT("Box filling both volumes is covered"), FAccess::IsCovered(FVector::ZeroVector, FVector(200, 100, 100), Volumes));
+	TestFalse(TEXT("Box past the outer face is not covered"), FAccess::IsCovered(FVector::ZeroVector, FVector(210, 50, 50), Volumes));
+	TestFalse(TEXT("Box above both volumes is not covered"), FAccess::IsCovered(FVector(0, 0, 80), FVector(50, 50, 50), Volumes));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRegionCoverageOverlappingTest, "RegionSystem.Region.Coverage.Overlapping", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRegionCoverageOverlappingTest::RunTest(const FString& Parameters)
+{
+	using FAccess = FRegionCoverageTestAccess;
+
+	//Two boxes overlapping between X = -50 and X = 50
+	const FAccess::FVolume Volumes[] = {
+		FAccess::MakeVolume(FVector(-75, 0, 0), FVector(125, 100, 100)),
+		FAccess::MakeVolume(FVector(75, 0, 0), FVector(125, 100, 100))
+	};
+
+	TestTrue(TEXT("Box in the overlap is covered"), FAccess::IsCovered(FVector::ZeroVector, FVector(25, 50, 50), Volumes));
+	TestTrue(TEXT("Box across both volumes is covered"), FAccess::IsCovered(FVector::ZeroVector, FVector(150, 50, 50), Volumes));
+	TestFalse(TEXT("Box past the side of both volumes is not covered"), FAccess::IsCovered(FVector(0, 80, 0), FVector(150, 50, 50), Volumes));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRegionCoverageGappedTest, "RegionSystem.Region.Coverage.Gapped", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRegionCoverageGappedTest::RunTest(const FString& Parameters)
+{
+	using FAccess = FRegionCoverageTestAccess;
+
+	//A gap of 0.5 units between X = 0 and X = 0.5
+	const FAccess::FVolume Volumes[] = {
+		FAccess::MakeVolume(FVector(-100, 0, 0), FVector(100)),
+		FAccess::MakeVolume(FVector(100.5, 0, 0), FVector(100))
+	};
+
+	TestFalse(TEXT("Box across the gap is not covered"), FAccess::IsCovered(FVector::ZeroVector, FVector(50), Volumes));
+	TestTrue(TEXT("Box next to the gap is covered"), FAccess::IsCovered(FVector(-50, 0, 0), FVector(40), Volumes));
+
+	//The same gap between rotated volumes is narrower than the cells at the maximum depth, so it has to fail closed
+	const FRotator Rotation(0, 45, 0);
+	const FVector Axis = Rotation.Vector();
+	const FAccess::FVolume RotatedVolumes[] = {
+		FAccess::MakeVolume(Axis * -100, FVector(100), Rotation),
+		FAccess::MakeVolume(Axis * 100.5, FVector(100), Rotation)
+	};
+
+	TestFalse(TEXT("Box across the gap of rotated volumes is not covered"), FAccess::IsCovered(Axis * 0.25, FVector(20), RotatedVolumes));
+	TestTrue(TEXT("Box inside one rotated volume is covered"), FAccess::IsCovered(Axis * -100, FVector(20), RotatedVolumes));
+	return true;
+}
+
+#endif
@@ -16,6 +16,8 @@ protected:
 #if WITH_EDITOR
 	
 	virtual void CalculateRelevantPoints_Implementation(ARegionPOI* POI, TArray<FVector>& OutPoints, bool& OutIsLocal) const override;
+	//Only projects onto the navigation
+	virtual bool SupportsParallelCalculation() const override { return true; }
 
 	FVector2D GetBoxExtents(ARegionPOI* POI) const;
 
@@ -24,8 +24,14 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "POI")
 	FLocationCache GetPOIRelevantPoints(ARegionPOI* POI) const;
 
+	//Whether GetPOIRelevantPoints may run on a worker thread during a parallel bake, never true for Blueprint overrides
+	bool CanCalculateInParallel() const;
+
 protected:
 
+	//Native processors that only trace and project onto the navigation can return true
+	virtual bool SupportsParallelCalculation() const { return false; }
+
 	//Overwrite this
 	UFUNCTION(BlueprintNativeEvent, Category = "POI")
 	void CalculateRelevantPoints(ARegionPOI* POI, TArray<FVector>& OutPoints, bool& OutIsLocal) const;
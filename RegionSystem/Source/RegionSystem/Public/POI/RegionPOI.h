@@ -49,6 +49,13 @@ protected:
 class UConvexPrimComponent;
 class UPOITypeProcessor;
 
+//Relevant point cache results of a bake
+struct FPOICacheStats
+{
+	int32 Hits = 0;
+	int32 Misses = 0;
+};
+
 UCLASS(Blueprintable, PrioritizeCategories = ("Regions"))
 class REGIONSYSTEM_API ARegionPOI : public AActor
 {
@@ -65,6 +72,7 @@ public:
 	virtual void PostEditMove(bool bFinished) override;
 
 	FGameplayTag GetContainingRegion() const;
+	void SetContainingRegion(FGameplayTag InContainingRegion) { ContainingRegion = InContainingRegion; }
 	FRegionPOIData GetData() const;
 	
 	void BakeAllRegions();
@@ -75,6 +83,19 @@ public:
 
 	UFUNCTION(CallInEditor, Category = "RegionPOI")
 	void Recalculate();
+	//Skips the processor if its inputs did not change since the points were calculated, returns true on a cache hit
+	bool RecalculateIfChanged(FPOICacheStats* Stats = nullptr);
+	//Hash of the POI and processor settings, the containing region volumes and the navigation inside them
+	uint32 CalculateInputHash() const { return CalculateInputHash(ContainingRegion); }
+	//Hash as if the POI was contained in RegionTag
+	uint32 CalculateInputHash(const FGameplayTag& RegionTag) const;
+
+	//Split up recalculation for the parallel bake, only the calculation may run off the game thread
+	bool HasProcessor() const { return POITypeProcessor != nullptr; }
+	bool IsCalculationCurrent(uint32 InputHash) const { return RelevantPointsHash != 0 && RelevantPointsHash == InputHash; }
+	bool CanCalculateInParallel() const;
+	FLocationCache CalculateRelevantPoints();
+	void ApplyRelevantPoints(FLocationCache&& InRelevantPoints, uint32 InputHash);
 
 #endif
 	
@@ -97,5 +118,8 @@ protected:
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "RegionPOI")
 	FLocationCache RelevantPoints {};
+	//Input hash RelevantPoints were calculated with, 0 if they were never calculated
+	UPROPERTY()
+	uint32 RelevantPointsHash = 0;
 #endif
 };
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "GameplayTagContainer.h"
 #include "RegionVolume.h"
 #include "UObject/Object.h"
+#include "UObject/ObjectKey.h"
 #include "Region.generated.h"
 
 class URegionTracker;
@@ -95,6 +96,8 @@ public:
 	URegionModule* GetRegionModule(TSubclassOf<URegionModule> ModuleClass, bool AllowParentSearch = true) const;
 	template<typename T>
 	T* GetRegionModule(bool AllowParentSearch = true) const;
+	//Module of the parent region, or with parent search of the closest ancestor that has one
+	URegionModule* GetParentRegionModule(TSubclassOf<URegionModule> ModuleClass, bool AllowParentSearch = true) const;
 
 protected:
 
@@ -114,6 +117,35 @@ protected:
 
 	//Helpers
 	TArray<FRegionPOIData> GetAllPOIs() const;
+
+	//Module Cache - lookups are cached per class, including classes that were not found
+	void InvalidateModuleCache() const;
+	void InvalidateInheritedModuleCache() const;
+	URegionModule* FindOwnRegionModule(TSubclassOf<URegionModule> ModuleClass) const;
+
+	mutable TMap<TObjectKey<UClass>, TWeakObjectPtr<URegionModule>> OwnModuleCache;
+	mutable TMap<TObjectKey<UClass>, TWeakObjectPtr<URegionModule>> InheritedModuleCache;
+	mutable TMap<TObjectKey<UClass>, TWeakObjectPtr<URegionModule>> AncestorModuleCache;
+
+	//Containment over several volumes. Axis aligned volumes are split on their faces and resolved exactly.
+	//Rotated volumes are only resolved down to MaxCoverageDepth, a remaining cell that no single volume holds counts as uncovered.
+	//Boxes across seams of rotated volumes may therefore be reported as not contained, but never the other way around.
+	friend struct FRegionCoverageTestAccess;
+	struct FRegionCoverageVolume
+	{
+		FRegionCoverageVolume(const FTransform& InTransform, const FVector& InExtent);
+
+		bool Overlaps(const FBox& Box) const;
+		bool ContainsPoint(const FVector& Point) const;
+		bool ContainsBox(const FBox& Box) const;
+
+		FTransform Transform;
+		FVector Extent;
+		FBox Bounds;
+		bool bAxisAligned = false;
+	};
+	static constexpr int32 MaxCoverageDepth = 12;
+	static bool IsCoveredByVolumes(const FBox& Box, TConstArrayView<FRegionCoverageVolume> CoverageVolumes, int32 Depth);
 	
 #pragma endregion
 
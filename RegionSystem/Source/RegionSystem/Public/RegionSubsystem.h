@@ -2,15 +2,20 @@
 
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
+#include "Containers/Ticker.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "Modules/RegionModuleDefaults.h"
+#include "Structs/GameplayTagTree.h"
+#include "Structs/RegionQuerySnapshot.h"
 #include "Structs/RegionTypes.h"
+#include <atomic>
 #include "RegionSubsystem.generated.h"
 
 class URegionModule;
 class URegionTracker;
 class URegion;
 class ARegionVolume;
+struct FPOICacheStats;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FRegionChange, URegion*, Region);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FRegionRefresh);
@@ -52,6 +57,10 @@ public:
 	FGameplayTagContainer GetAllRegionTags() const;
 	UFUNCTION(BlueprintCallable)
 	TSet<ARegionVolume*> GetAllRegionVolumes() const;
+
+	//Hierarchy - answered by the region tree, the tag does not need to belong to a live region
+	URegion* GetParentRegion(FGameplayTag RegionTag) const;
+	TSet<URegion*> GetChildRegions(FGameplayTag RegionTag) const;
 	
 	//Region Gets
 	UFUNCTION(BlueprintCallable, DisplayName = "Get Region (By Tag)", meta = (Categories = "Regions.Areas", AdvancedDisplay = 1))
@@ -82,11 +91,29 @@ public:
 	FGameplayTag GetRegionTagByTracker(URegionTracker* Tracker) const;
 	UFUNCTION(BlueprintCallable, DisplayName = "Get Region Tag (By Player State)")
 	FGameplayTag GetRegionTagByState(APlayerState* PlayerState) const;
+
+	//Volumes containing the location, answered from the query snapshot
+	void GetRegionVolumesByLocation(FVector Location, TArray<ARegionVolume*>& OutVolumes) const;
+
+	//Batch Queries - every tag matches GetRegionTagByLocation for the same location
+	void GetRegionTagsByLocations(TConstArrayView<FVector> Locations, TArray<FGameplayTag>& OutTags, ERegionTypes DesiredType = ERegionTypes::Room) const;
+
+	//Snapshot - safe to call from any thread, only the game thread rebuilds an outdated snapshot
+	TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> GetQuerySnapshot() const;
+	//Increases with every region or volume change, including moved or resized volumes. A snapshot with a lower version is stale
+	uint32 GetRegionVersion() const { return RegionVersion.load(std::memory_order_acquire); }
+	bool IsSnapshotCurrent(const FRegionQuerySnapshot& Snapshot) const;
+	//Builds a new snapshot from the live regions, game thread only
+	TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> CreateQuerySnapshot() const;
+
+	virtual void Deinitialize() override;
 	
 private:
 
 	UPROPERTY(Transient)
 	TMap<FGameplayTag, TObjectPtr<URegion>> RegionMap;
+	//Mirrors RegionMap, which keeps the regions referenced
+	TGameplayTagTree<URegion*> RegionTree;
 
 	UPROPERTY(Transient)
 	FRegionModuleDefaults ModuleDefaults {};
@@ -100,15 +127,30 @@ private:
 protected:
 
 	friend ARegionVolume;
+	friend URegionTracker;
 
-	//ONLY FOR REGION VOLUMES TO CALL
+	//ONLY FOR REGION VOLUMES AND TRACKERS TO CALL
 	void RegisterVolume(ARegionVolume* Volume);
 	void DeregisterVolume(ARegionVolume* Volume);
+	//The volume was moved or resized
+	void VolumeChanged(ARegionVolume* Volume);
 
 	bool EnterRegionVolume(URegionTracker* Tracker, const ARegionVolume* Volume) const;
 	bool ExitRegionVolume(URegionTracker* Tracker, const ARegionVolume* Volume) const;
 #pragma endregion
 
+#pragma region Snapshot
+private:
+
+	void MarkRegionsChanged();
+	void PublishQuerySnapshot() const;
+
+	std::atomic<uint32> RegionVersion = 0;
+	mutable FCriticalSection SnapshotLock;
+	mutable TSharedRef<const FRegionQuerySnapshot, ESPMode::ThreadSafe> PublishedSnapshot = MakeShared<FRegionQuerySnapshot, ESPMode::ThreadSafe>();
+	FTSTicker::FDelegateHandle PublishTickerHandle;
+#pragma endregion
+
 #pragma region Editor
 #if WITH_EDITOR
 public:
@@ -127,8 +169,24 @@ public:
 	UFUNCTION()
 	void ForceRefreshRegions();
 
+	//Part of the POI cache key, hash of the navmesh polygons inside the volumes of the region
+	uint32 GetNavigationHash(const FGameplayTag& RegionTag);
+	int32 GetLastBakeCacheHits() const { return LastBakeCacheHits; }
+	int32 GetLastBakeCacheMisses() const { return LastBakeCacheMisses; }
+
 private:
-	void BakeRegion(URegion* Region);
+	//Collects POI cache stats into the passed stats, or reports them itself if none are passed
+	void BakeRegion(URegion* Region, FPOICacheStats* CacheStats = nullptr);
+	void ReportBakeCacheStats(const FPOICacheStats& CacheStats);
+
+	uint32 CalculateNavigationHash(const FBox& Bounds) const;
+
+	//Only set during a bake, the navigation is not rebuilt in between
+	TOptional<TMap<FGameplayTag, uint32>> BakeNavigationHashes;
+	int32 LastBakeCacheHits = 0;
+	int32 LastBakeCacheMisses = 0;
+	//Returns false if the bake was cancelled, nothing is changed then
+	bool BakeRegionsParallel();
 
 #endif
 #pragma endregion
@@ -4,16 +4,36 @@
 #include "GameplayTagContainer.h"
 #include "RegionObjectInterface.h"
 #include "Components/PlayerStateComponent.h"
+#include "ReplicatedObject/ReplicationRelevancyInterface.h"
 #include "RegionTracker.generated.h"
 
 
 class URegion;
+class ARegionVolume;
 class UAbilitySystemComponent;
 
+USTRUCT(BlueprintType)
+struct FRegionTrackerChange
+{
+	GENERATED_BODY()
+
+	//Deepest region before and after the change
+	UPROPERTY(BlueprintReadOnly, Category="Regions")
+	FGameplayTag PreviousRegionTag;
+	UPROPERTY(BlueprintReadOnly, Category="Regions")
+	FGameplayTag NewRegionTag;
+
+	UPROPERTY(BlueprintReadOnly, Category="Regions")
+	FGameplayTagContainer EnteredTags;
+	UPROPERTY(BlueprintReadOnly, Category="Regions")
+	FGameplayTagContainer ExitedTags;
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRegionChange, FGameplayTag, RegionTag);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnRegionTransition, const FRegionTrackerChange&, Change);
 
 UCLASS(ClassGroup=(Custom), meta=(BlueprintSpawnableComponent))
-class REGIONSYSTEM_API URegionTracker : public UGameFrameworkComponent, public IRegionObject
+class REGIONSYSTEM_API URegionTracker : public UGameFrameworkComponent, public IRegionObject, public IReplicationRelevancy
 {
 	GENERATED_BODY()
 
@@ -23,19 +43,41 @@ class REGIONSYSTEM_API URegionTracker : public UGameFrameworkComponent, public I
 	virtual void GetCheckData_Implementation(FVector& CheckLocation, ERegionTypes& DesiredType, bool& bDisableRuntimeChecks) const override;
 	//Region Object Interface
 
+	//Replication Relevancy Interface
+	virtual bool IsRelevantForTag_Implementation(FGameplayTag RelevancyTag) const override;
+	//Replication Relevancy Interface
+
 public:
 
+	URegionTracker();
+
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	//Point Tracking - enters and exits volumes by the owner location, used when the settings disable overlaps
+	UFUNCTION(BlueprintCallable)
+	void UpdatePointTracking();
 
 	UPROPERTY(BlueprintAssignable, Category="Regions")
 	FOnRegionChange OnRegionEnter;
 	UPROPERTY(BlueprintAssignable, Category="Regions")
 	FOnRegionChange OnRegionExit;
+	//Fires once per change, or once per frame when coalescing
+	UPROPERTY(BlueprintAssignable, Category="Regions")
+	FOnRegionTransition OnRegionChanged;
+
+	//Collects all enters and exits of a frame into one OnRegionChanged. The tracker queries are updated right away.
+	//OnRegionEnter and OnRegionExit do not fire at all, existing listeners have to move to OnRegionChanged.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Regions")
+	bool bCoalesceRegionChanges = false;
 	
 	UFUNCTION(BlueprintCallable)
 	bool IsInRegion(FGameplayTag Tag) const;
 	UFUNCTION(BlueprintCallable)
 	FGameplayTagContainer GetRegionTags() const;
+	//Same tags without the copy, parent tags are included for HasTag
+	const FGameplayTagContainer& GetRegionTagsRef() const { return CachedRegionTags; }
 	UFUNCTION(BlueprintCallable)
 	FGameplayTag GetContainingRegionTag() const;
 	UFUNCTION(BlueprintCallable)
@@ -55,9 +97,26 @@ protected:
 	void RemoveRegion(URegion* Region);
 	UFUNCTION()
 	FGameplayTag CalculateRelevantRegion() const;
+
+	//Changes - the state before the first change is kept until the change is flushed
+	void BeginRegionChange();
+	UFUNCTION()
+	void FlushRegionChange();
+	void ApplyLooseRegionTag(FGameplayTag PreviousRegionTag, FGameplayTag NewRegionTag) const;
+
+	bool bRegionChangePending = false;
+	FGameplayTag PendingPreviousRegionTag;
+	FGameplayTagContainer PendingPreviousRegionTags;
+	FGameplayTagContainer PendingChangedTags;
 	
 	UPROPERTY(Transient)
 	TSet<TWeakObjectPtr<URegion>> RegionRefs;
+	//Kept in sync with RegionRefs
+	UPROPERTY(Transient)
+	FGameplayTagContainer CachedRegionTags;
+	//Volumes containing the owner at the last point query
+	UPROPERTY(Transient)
+	TArray<TWeakObjectPtr<ARegionVolume>> PointTrackedVolumes;
 	UPROPERTY(Transient)
 	mutable FGameplayTag CachedRegionTag;
 	
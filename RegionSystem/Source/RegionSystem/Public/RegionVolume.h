@@ -37,6 +37,7 @@ class UTextRenderComponent;
 class URegionEditorSubsystem;
 class URegionSubsystem;
 class UBoxComponent;
+struct FPOICacheStats;
 
 UCLASS(Blueprintable, PrioritizeCategories = ("Regions"))
 class REGIONSYSTEM_API ARegionVolume : public AActor
@@ -76,6 +77,11 @@ public:
 	bool Contains(FVector Location) const;
 	UFUNCTION(BlueprintCallable)
 	bool ContainsFully(FVector Location, FVector BoxExtent) const;
+	FTransform GetBoxTransform() const;
+	FVector GetUnscaledBoxExtent() const;
+	//Resizes the volume at runtime, extent changes made on RegionBox directly are not picked up by the region queries
+	UFUNCTION(BlueprintCallable)
+	void SetBoxExtent(FVector InBoxExtent);
 
 	//POI
 	UFUNCTION(BlueprintCallable)
@@ -94,6 +100,9 @@ protected:
 	void RegisterSelfWithSubsystem();
 	UFUNCTION()
 	void DeregisterSelfWithSubsystem();
+	//Moving or scaling the volume outdates the region query snapshot
+	void OnRegionBoxTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+	void NotifyVolumeChanged();
 
 	UFUNCTION()
 	float GetTextScale() const;
@@ -135,7 +144,10 @@ public:
 
 	UFUNCTION(CallInEditor, Category = "Regions")
 	void SetExtension();
-	void Bake();
+	//Returns the collected POI data, without the fallback
+	TArray<FRegionPOIData> Bake(FPOICacheStats* CacheStats = nullptr);
+	//Stores already collected POI data, falls back to the projected volume location when empty
+	void SetBakedPOIData(TArray<FRegionPOIData>&& InPOIData);
 	
 	void HideVolume();
 	void ShowVolume();
@@ -4,6 +4,7 @@
 #include "Engine/DeveloperSettings.h"
 #include "Modules/RegionModuleDefaults.h"
 #include "Modules/Implementations/Electricity/Consumer/ElectricityConsumerType.h"
+#include "Structs/RegionTypes.h"
 #include "Structs/TimeData.h"
 #include "RegionSettings.generated.h"
 
@@ -21,6 +22,7 @@ public:
 
 	static bool GetDefaultModuleFuzeState();
 	static bool IsTypeEnabledByDefault(EElectricityConsumerType ElectricityConsumer);
+	static bool UsePointTracking();
 	
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config)
 	TSet<TSubclassOf<URegionModule>> ImplementedModuleClasses;
@@ -28,6 +30,21 @@ public:
 	bool bAutoBakePOIs = true;
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config)
 	bool bForceVolumeBoxChecks = false;
+	//Baking all regions finds the regions of all POIs and runs native POI processors on worker threads, the result is the same as a serial bake
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config)
+	bool bParallelBake = false;
+
+	//Tracking
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config, Category = "Tracking")
+	ERegionTrackingMode TrackingMode = ERegionTrackingMode::Overlap;
+	//Seconds between point queries of a tracker, 0 queries every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config, Category = "Tracking", meta = (ClampMin = 0, EditCondition = "TrackingMode == ERegionTrackingMode::PointQuery"))
+	float PointQueryInterval = 0.f;
+
+	//Replication
+	//Regions whose scoped global replicator keys are also sent to trackers in the mapped neighbor regions
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config, Category = "Replication", meta = (Categories = "Regions.Areas"))
+	TMap<FGameplayTag, FGameplayTagContainer> RelevancyNeighbors;
 
 	//Electricity
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Config, Category = "Electricity")
@@ -5,7 +5,6 @@
 #include "GameplayTagTreeNotifier.h" // Your notifier interface header.
 #include "Containers/Map.h"
 #include "Containers/Array.h"
-#include "Extensions/GameplayTagExtensions.h" // Must supply GetParentGameplayTag()
 #include "Templates/SharedPointer.h"
 #include "Templates/UnrealTypeTraits.h" // For TIsDerivedFrom, TRemovePointer
 #include "UObject/Class.h"             // For Cast<>
@@ -335,6 +334,70 @@ public:
 		return RootNodes;
 	}
 
+	//-------------------------------------------------
+	// Ancestor and descendant lookups.
+	//-------------------------------------------------
+
+	// Finds the closest inserted ancestor of a tag, the tag itself does not need to be inserted.
+	TSharedPtr<FGameplayTagTreeNode<T>> FindClosestAncestor(const FGameplayTag& InTag) const
+	{
+		FGameplayTag ParentTag = InTag.RequestDirectParent();
+		while (ParentTag.IsValid())
+		{
+			TSharedPtr<FGameplayTagTreeNode<T>> AncestorNode = FindNode(ParentTag);
+			if (AncestorNode.IsValid())
+			{
+				return AncestorNode;
+			}
+			ParentTag = ParentTag.RequestDirectParent();
+		}
+		return nullptr;
+	}
+
+	// Returns the value of the tag or, if it is not inserted, of its closest inserted ancestor.
+	T* FindClosest(const FGameplayTag& InTag) const
+	{
+		if (T* Found = Find(InTag))
+		{
+			return Found;
+		}
+		if (TSharedPtr<FGameplayTagTreeNode<T>> AncestorNode = FindClosestAncestor(InTag))
+		{
+			return &AncestorNode->Value;
+		}
+		return nullptr;
+	}
+
+	// Appends the values of all nodes below the tag, the tag itself is not included.
+	void GetDescendants(const FGameplayTag& InTag, TArray<T>& OutValues) const
+	{
+		TSharedPtr<FGameplayTagTreeNode<T>> Node = FindNode(InTag);
+		if (!Node.IsValid())
+		{
+			return;
+		}
+
+		TArray<FGameplayTagTreeNode<T>*, TInlineAllocator<16>> Stack;
+		for (const TSharedPtr<FGameplayTagTreeNode<T>>& Child : Node->Children)
+		{
+			Stack.Add(Child.Get());
+		}
+		while (Stack.Num() > 0)
+		{
+			FGameplayTagTreeNode<T>* Current = Stack.Pop(EAllowShrinking::No);
+			OutValues.Add(Current->Value);
+			for (const TSharedPtr<FGameplayTagTreeNode<T>>& Child : Current->Children)
+			{
+				Stack.Add(Child.Get());
+			}
+		}
+	}
+
+	int32 Num() const
+	{
+		return NodeMap.Num();
+	}
+
 	//-------------------------------------------------
 	// GetEntries: Returns a TArray of tuples (FGameplayTag, T).
 	//-------------------------------------------------
@@ -390,22 +453,6 @@ private:
 		return nullptr;
 	}
 
-	// Helper: Finds the closest ancestor node for the given tag.
-	TSharedPtr<FGameplayTagTreeNode<T>> FindClosestAncestor(const FGameplayTag& InTag)
-	{
-		FGameplayTag ParentTag = UGameplayTagExtensions::GetParentGameplayTag(InTag);
-		while (ParentTag.IsValid())
-		{
-			TSharedPtr<FGameplayTagTreeNode<T>> AncestorNode = FindNode(ParentTag);
-			if (AncestorNode.IsValid())
-			{
-				return AncestorNode;
-			}
-			ParentTag = UGameplayTagExtensions::GetParentGameplayTag(ParentTag);
-		}
-		return nullptr;
-	}
-
 	// Internal storage.
 	TMap<FGameplayTag, TSharedPtr<FGameplayTagTreeNode<T>>> NodeMap;
 	TArray<TSharedPtr<FGameplayTagTreeNode<T>>> RootNodes;
@@ -0,0 +1,103 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "Structs/RegionTypes.h"
+
+class ARegionVolume;
+
+/**
+ * Plain copy of the region volumes, tags and hierarchy, built on the game thread by URegionSubsystem.
+ * Holds no UObjects and is never modified once published, so queries can run on any thread without locking.
+ * Location queries give the same result as URegionSubsystem::GetRegionTagByLocation at the time it was built.
+ * Finalize buckets the volume bounds into a uniform grid, so a location query only tests the volumes of one cell.
+ */
+struct REGIONSYSTEM_API FRegionQuerySnapshot
+{
+	explicit FRegionQuerySnapshot(uint32 InVersion = 0) : Version(InVersion) {  }
+
+	struct FVolume
+	{
+		FTransform Transform;
+		FVector Extent = FVector::ZeroVector;
+		//World space bounds of the box, only used to reject points early
+		FBox Bounds = FBox(ForceInit);
+		//Only resolve on the game thread
+		TWeakObjectPtr<ARegionVolume> Actor;
+	};
+
+	//Regions keep the order of the subsystem's region map, ties on depth resolve to the first region like the single query
+	struct FRegion
+	{
+		FGameplayTag Tag;
+		ERegionTypes Type = ERegionTypes::Room;
+		int32 TagDepth = 0;
+		int32 ParentIndex = INDEX_NONE;
+		int32 FirstVolume = 0;
+		int32 NumVolumes = 0;
+	};
+
+	//Building - the parent is the closest live ancestor, links are resolved by Finalize
+	void AddRegion(FGameplayTag Tag, FGameplayTag ParentTag = FGameplayTag());
+	void AddVolume(const FTransform& Transform, const FVector& Extent, TWeakObjectPtr<ARegionVolume> Actor = nullptr);
+	void Finalize();
+
+	//Version of the region subsystem this was built from
+	uint32 GetVersion() const { return Version; }
+
+	bool Contains(int32 RegionIndex, const FVector& Location) const;
+	bool Contains(FGameplayTag RegionTag, const FVector& Location) const;
+	bool VolumeContains(int32 VolumeIndex, const FVector& Location) const;
+	//Volume indices are added in ascending order
+	template<typename AllocatorType>
+	void GetVolumesByLocation(const FVector& Location, TArray<int32, AllocatorType>& OutVolumeIndices) const;
+
+	//Hierarchy - only walks the stored parent links, so no gameplay tag lookups are needed
+	int32 FindRegionIndex(FGameplayTag RegionTag) const;
+	FGameplayTag GetParentRegionTag(FGameplayTag RegionTag) const;
+	//Plain array, filling a tag container would go through the gameplay tag manager
+	void GetChildRegionTags(FGameplayTag RegionTag, TArray<FGameplayTag>& OutTags, bool bRecursive = true) const;
+	bool IsChildRegionOf(FGameplayTag RegionTag, FGameplayTag ParentTag) const;
+
+	//Returns the most detailed containing region of the desired type, or the most detailed containing region of any type
+	FGameplayTag GetRegionTagByLocation(const FVector& Location, ERegionTypes DesiredType, bool* bOutUsedFallback = nullptr) const;
+	//Returns the number of locations that fell back to another region type
+	int32 GetRegionTagsByLocations(TConstArrayView<FVector> Locations, TArrayView<FGameplayTag> OutTags, ERegionTypes DesiredType) const;
+
+	const TArray<FRegion>& GetRegions() const { return Regions; }
+	const TArray<FVolume>& GetVolumes() const { return Volumes; }
+
+private:
+
+	bool IsChildRegionOf(int32 RegionIndex, int32 ParentIndex) const;
+
+	void BuildGrid();
+	//Volumes whose bounds touch the grid cell of the location, in ascending order
+	TConstArrayView<int32> GetCandidateVolumes(const FVector& Location) const;
+
+	uint32 Version = 0;
+	TArray<FRegion> Regions;
+	TArray<FVolume> Volumes;
+	//Region of every volume
+	TArray<int32> VolumeRegions;
+	TMap<FGameplayTag, int32> RegionIndices;
+	TArray<FGameplayTag> PendingParentTags;
+
+	//The volumes of cell Index are GridVolumes[GridCellOffsets[Index]] to GridVolumes[GridCellOffsets[Index + 1]]
+	static constexpr int32 MaxGridCellsPerAxis = 16;
+	FBox GridBounds = FBox(ForceInit);
+	FVector GridCellSize = FVector::OneVector;
+	FIntVector GridCells = FIntVector::ZeroValue;
+	TArray<int32> GridCellOffsets;
+	TArray<int32> GridVolumes;
+};
+
+template <typename AllocatorType>
+void FRegionQuerySnapshot::GetVolumesByLocation(const FVector& Location, TArray<int32, AllocatorType>& OutVolumeIndices) const
+{
+	for (const int32 VolumeIndex : GetCandidateVolumes(Location))
+	{
+		if (VolumeContains(VolumeIndex, Location))
+			OutVolumeIndices.Add(VolumeIndex);
+	}
+}
@@ -8,3 +8,12 @@ enum class ERegionTypes : uint8
 	Room,
 	Master UMETA(Hidden),
 };
+
+UENUM(BlueprintType)
+enum class ERegionTrackingMode : uint8
+{
+	//Trackers are updated by overlap events of the region volumes
+	Overlap,
+	//Trackers query the region subsystem with their location, region volumes do not generate overlaps
+	PointQuery,
+};
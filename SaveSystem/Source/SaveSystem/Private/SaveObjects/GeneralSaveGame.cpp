@@ -1,16 +1,49 @@
 #include "SaveObjects/GeneralSaveGame.h"
 
 #include "GameplayTagContainer.h"
+#include "SaveSettings.h"
+#include "SaveSubSystem.h"
+#include "Misc/Compression.h"
 #include "Save/ObjectSerializationLibrary.h"
 
+UGeneralSaveGame::UGeneralSaveGame()
+{
+	//Loaded saves overwrite this with the compression they were written with
+	if (const USaveSettings* SaveSettings = USaveSettings::Get())
+		SlotCompression = SaveSettings->DefaultSaveCompression;
+}
+
 void UGeneralSaveGame::AddData(FGameplayTag Tag, FObjectData Data)
 {
+	AddDataWithCompression(Tag, Data, SlotCompression);
+}
+
+void UGeneralSaveGame::AddDataWithCompression(FGameplayTag Tag, FObjectData Data, ESaveCompressionCodec Codec)
+{
+	SaveVersion = LatestSaveVersion;
+	Codec = ResolveCodec(Codec);
+
+	FCompressedObjectData CompressedData;
+	if (Codec != ESaveCompressionCodec::None && CompressBytes(Codec, Data.Data, CompressedData.Data))
+	{
+		CompressedData.ObjectClass = Data.ObjectClass;
+		CompressedData.Codec = Codec;
+		CompressedData.UncompressedSize = Data.Data.Num();
+
+		TagDataPairs.Remove(Tag);
+		CompressedTagDataPairs.Add(Tag, CompressedData);
+		return;
+	}
+
+	//Uncompressed or not worth compressing
+	CompressedTagDataPairs.Remove(Tag);
 	TagDataPairs.Add(Tag, Data);
 }
 
 bool UGeneralSaveGame::RemoveData(FGameplayTag Tag)
 {
 	int Index = TagDataPairs.Remove(Tag);
+	Index += CompressedTagDataPairs.Remove(Tag);
 	return Index >= 0;
 }
 
@@ -21,12 +54,129 @@ bool UGeneralSaveGame::GetData(FGameplayTag Tag, FObjectData& Data)
 		Data = *FoundData;
 		return true;
 	}
-	
+
+	if (FCompressedObjectData* FoundCompressedData = CompressedTagDataPairs.Find(Tag))
+	{
+		Data.ObjectClass = FoundCompressedData->ObjectClass;
+		if (DecompressBytes(FoundCompressedData->Codec, FoundCompressedData->Data, FoundCompressedData->UncompressedSize, Data.Data))
+			return true;
+
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to decompress save data for %s"), *Tag.GetTagName().ToString());
+	}
+
 	Data = FObjectData();
 	return false;
 }
 
 TMap<FGameplayTag, FObjectData> UGeneralSaveGame::GetAllData()
 {
-	return TagDataPairs;
+	TMap<FGameplayTag, FObjectData> AllData = TagDataPairs;
+	AllData.Reserve(TagDataPairs.Num() + CompressedTagDataPairs.Num());
+
+	for (const auto& Pair : CompressedTagDataPairs)
+	{
+		FObjectData Data;
+		if (GetData(Pair.Key, Data))
+			AllData.Add(Pair.Key, Data);
+	}
+	return AllData;
+}
+
+TArray<FSaveCompressionBenchmarkResult> UGeneralSaveGame::BenchmarkCompression(const TArray<FObjectData>& Samples, int32 Iterations)
+{
+	Iterations = FMath::Max(Iterations, 1);
+
+	TArray<FSaveCompressionBenchmarkResult> Results;
+	for (ESaveCompressionCodec RequestedCodec : { ESaveCompressionCodec::None, ESaveCompressionCodec::Zlib, ESaveCompressionCodec::Oodle })
+	{
+		const ESaveCompressionCodec Codec = ResolveCodec(RequestedCodec);
+		FSaveCompressionBenchmarkResult& Result = Results.AddDefaulted_GetRef();
+		Result.Codec = Codec;
+
+		for (int32 Iteration = 0; Iteration < Iterations; Iteration++)
+		{
+			for (const FObjectData& Sample : Samples)
+			{
+				TArray<uint8> CompressedBytes;
+				double StartTime = FPlatformTime::Seconds();
+				const bool bCompressed = Codec != ESaveCompressionCodec::None && CompressBytes(Codec, Sample.Data, CompressedBytes);
+				Result.CompressMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+				if (!bCompressed)
+					CompressedBytes = Sample.Data;
+
+				TArray<uint8> DecompressedBytes;
+				StartTime = FPlatformTime::Seconds();
+				if (bCompressed)
+					DecompressBytes(Codec, CompressedBytes, Sample.Data.Num(), DecompressedBytes);
+				Result.DecompressMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+				if (Iteration == 0)
+				{
+					Result.UncompressedBytes += Sample.Data.Num();
+					Result.CompressedBytes += CompressedBytes.Num();
+				}
+			}
+		}
+
+		Result.CompressMs /= Iterations;
+		Result.DecompressMs /= Iterations;
+	}
+
+	return Results;
+}
+
+bool UGeneralSaveGame::CompressBytes(ESaveCompressionCodec Codec, const TArray<uint8>& InBytes, TArray<uint8>& OutBytes)
+{
+	const FName FormatName = GetFormatName(Codec);
+	if (FormatName.IsNone() || InBytes.IsEmpty())
+		return false;
+
+	int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, InBytes.Num());
+	OutBytes.SetNumUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(FormatName, OutBytes.GetData(), CompressedSize, InBytes.GetData(), InBytes.Num()))
+		return false;
+
+	//Not worth storing compressed
+	if (CompressedSize >= InBytes.Num())
+		return false;
+
+	OutBytes.SetNum(CompressedSize);
+	return true;
+}
+
+bool UGeneralSaveGame::DecompressBytes(ESaveCompressionCodec Codec, const TArray<uint8>& InBytes, int32 UncompressedSize, TArray<uint8>& OutBytes)
+{
+	if (Codec == ESaveCompressionCodec::None)
+	{
+		OutBytes = InBytes;
+		return true;
+	}
+
+	const FName FormatName = GetFormatName(Codec);
+	if (FormatName.IsNone() || UncompressedSize < 0)
+		return false;
+
+	OutBytes.SetNumUninitialized(UncompressedSize);
+	return FCompression::UncompressMemory(FormatName, OutBytes.GetData(), UncompressedSize, InBytes.GetData(), InBytes.Num());
+}
+
+ESaveCompressionCodec UGeneralSaveGame::ResolveCodec(ESaveCompressionCodec Codec)
+{
+	if (Codec == ESaveCompressionCodec::Oodle && !FCompression::IsFormatValid(NAME_Oodle))
+		return ESaveCompressionCodec::Zlib;
+	return Codec;
+}
+
+FName UGeneralSaveGame::GetFormatName(ESaveCompressionCodec Codec)
+{
+	switch (Codec)
+	{
+	case ESaveCompressionCodec::Oodle:
+		return NAME_Oodle;
+	case ESaveCompressionCodec::Zlib:
+		return NAME_Zlib;
+	default:
+		return NAME_None;
+	}
 }
@@ -0,0 +1,403 @@
+#include "SaveObjects/IndexedSaveArchive.h"
+
+#include "SaveSubSystem.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace IndexedSaveArchive
+{
+	//"SSIA"
+	static constexpr uint32 Magic = 0x41495353;
+	static constexpr uint32 Version = 1;
+	//Magic, Version
+	static constexpr int64 HeaderSize = sizeof(uint32) + sizeof(uint32);
+	//Table Of Contents Offset, Table Of Contents Size, Table Of Contents CRC, Magic
+	static constexpr int64 FooterSize = sizeof(int64) + sizeof(int64) + sizeof(uint32) + sizeof(uint32);
+	static constexpr int64 ScanChunkSize = 64 * 1024;
+}
+
+bool FIndexedSaveArchive::Open()
+{
+	Entries.Reset();
+	StagedEntries.Reset();
+	StagedRemovals.Reset();
+	ReadHandle.Reset();
+	FileSize = 0;
+	LiveBytes = 0;
+	bOpen = false;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.FileExists(*FilePath))
+	{
+		bOpen = true;
+		return true;
+	}
+
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenRead(*FilePath));
+	if (!Handle)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to open save archive %s"), *FilePath);
+		return false;
+	}
+	FileSize = Handle->Size();
+
+	uint32 Header[2] = {};
+	if (FileSize < IndexedSaveArchive::HeaderSize + IndexedSaveArchive::FooterSize
+		|| !Handle->Read(reinterpret_cast<uint8*>(Header), sizeof(Header))
+		|| Header[0] != IndexedSaveArchive::Magic)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("%s is not a save archive"), *FilePath);
+		return false;
+	}
+
+	if (Header[1] > IndexedSaveArchive::Version)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Save archive %s has unsupported version %u"), *FilePath, Header[1]);
+		return false;
+	}
+
+	if (!ReadTableOfContents(*Handle, FileSize - IndexedSaveArchive::FooterSize))
+	{
+		//An interrupted append leaves incomplete data behind the last complete table of contents
+		UE_LOG(LogSaveSystem, Warning, TEXT("Save archive %s has no valid table of contents at its end, searching for the last complete one"), *FilePath);
+		if (!FindLastValidFooter(*Handle))
+		{
+			UE_LOG(LogSaveSystem, Error, TEXT("Corrupt save archive %s: No valid table of contents found"), *FilePath);
+			return false;
+		}
+	}
+
+	bOpen = true;
+	return true;
+}
+
+bool FIndexedSaveArchive::HasEntry(const FString& Name) const
+{
+	if (StagedEntries.Contains(Name))
+		return true;
+
+	return !StagedRemovals.Contains(Name) && Entries.Contains(Name);
+}
+
+bool FIndexedSaveArchive::ReadEntry(const FString& Name, TArray<uint8>& OutBytes) const
+{
+	if (const TArray<uint8>* StagedBytes = StagedEntries.Find(Name))
+	{
+		OutBytes = *StagedBytes;
+		return true;
+	}
+
+	if (StagedRemovals.Contains(Name))
+		return false;
+
+	const FEntry* Entry = Entries.Find(Name);
+	if (!Entry)
+		return false;
+
+	IFileHandle* Handle = GetReadHandle();
+	return Handle && ReadEntryFromHandle(*Handle, Name, *Entry, OutBytes);
+}
+
+void FIndexedSaveArchive::WriteEntry(const FString& Name, TArray<uint8> Bytes)
+{
+	StagedRemovals.Remove(Name);
+	StagedEntries.Add(Name, MoveTemp(Bytes));
+}
+
+void FIndexedSaveArchive::RemoveEntry(const FString& Name)
+{
+	StagedEntries.Remove(Name);
+	if (Entries.Contains(Name))
+		StagedRemovals.Add(Name);
+}
+
+bool FIndexedSaveArchive::Flush()
+{
+	if (!bOpen)
+		return false;
+
+	if (StagedEntries.IsEmpty() && StagedRemovals.IsEmpty())
+		return true;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+
+	ReadHandle.Reset();
+	TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*FilePath, /*bAppend*/ true));
+	if (!Handle)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to open save archive %s for writing"), *FilePath);
+		return false;
+	}
+
+	int64 Offset = Handle->Size();
+	if (Offset == 0)
+	{
+		uint32 Header[2] = { IndexedSaveArchive::Magic, IndexedSaveArchive::Version };
+		if (!Handle->Write(reinterpret_cast<const uint8*>(Header), sizeof(Header)))
+			return false;
+		Offset = IndexedSaveArchive::HeaderSize;
+	}
+
+	TMap<FString, FEntry> NewEntries = Entries;
+	for (const FString& Name : StagedRemovals)
+	{
+		NewEntries.Remove(Name);
+	}
+
+	for (const auto& Pair : StagedEntries)
+	{
+		FEntry Entry;
+		Entry.Offset = Offset;
+		Entry.Size = Pair.Value.Num();
+		Entry.Crc = FCrc::MemCrc32(Pair.Value.GetData(), Pair.Value.Num());
+
+		if (!Handle->Write(Pair.Value.GetData(), Entry.Size))
+		{
+			UE_LOG(LogSaveSystem, Error, TEXT("Failed to append %s to save archive %s"), *Pair.Key, *FilePath);
+			return false;
+		}
+
+		NewEntries.Add(Pair.Key, Entry);
+		Offset += Entry.Size;
+	}
+
+	if (!WriteTableOfContents(*Handle, NewEntries, Offset) || !Handle->Flush(true))
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to write table of contents of save archive %s"), *FilePath);
+		return false;
+	}
+
+	Entries = MoveTemp(NewEntries);
+	FileSize = Handle->Size();
+	StagedEntries.Reset();
+	StagedRemovals.Reset();
+	UpdateLiveBytes();
+	return true;
+}
+
+bool FIndexedSaveArchive::Compact()
+{
+	if (!Flush())
+		return false;
+
+	if (FileSize == 0)
+		return true;
+
+	IFileHandle* Source = GetReadHandle();
+	if (!Source)
+		return false;
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString TempPath = FilePath + TEXT(".tmp");
+
+	TMap<FString, FEntry> NewEntries;
+	{
+		TUniquePtr<IFileHandle> Target(PlatformFile.OpenWrite(*TempPath));
+		if (!Target)
+		{
+			UE_LOG(LogSaveSystem, Error, TEXT("Failed to open %s for compaction"), *TempPath);
+			return false;
+		}
+
+		uint32 Header[2] = { IndexedSaveArchive::Magic, IndexedSaveArchive::Version };
+		bool bSuccess = Target->Write(reinterpret_cast<const uint8*>(Header), sizeof(Header));
+
+		int64 Offset = IndexedSaveArchive::HeaderSize;
+		TArray<uint8> Bytes;
+		for (const auto& Pair : Entries)
+		{
+			if (!bSuccess)
+				break;
+
+			//Corrupt entries are dropped, they could not be loaded anyway
+			if (!ReadEntryFromHandle(*Source, Pair.Key, Pair.Value, Bytes))
+				continue;
+
+			bSuccess = Target->Write(Bytes.GetData(), Bytes.Num());
+			NewEntries.Add(Pair.Key, FEntry { Offset, Bytes.Num(), Pair.Value.Crc });
+			Offset += Bytes.Num();
+		}
+
+		if (!bSuccess || !WriteTableOfContents(*Target, NewEntries, Offset) || !Target->Flush(true))
+		{
+			UE_LOG(LogSaveSystem, Error, TEXT("Failed to write compacted save archive %s"), *TempPath);
+			Target.Reset();
+			PlatformFile.DeleteFile(*TempPath);
+			return false;
+		}
+	}
+
+	ReadHandle.Reset();
+	if (!USaveSubSystem::ReplaceFile(FilePath, TempPath))
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to replace save archive %s with its compacted version"), *FilePath);
+		return false;
+	}
+
+	const int64 OldFileSize = FileSize;
+	Entries = MoveTemp(NewEntries);
+	FileSize = PlatformFile.FileSize(*FilePath);
+	UpdateLiveBytes();
+
+	UE_LOG(LogSaveSystem, Log, TEXT("Compacted save archive %s from %lld to %lld bytes"), *FilePath, OldFileSize, FileSize);
+	return true;
+}
+
+bool FIndexedSaveArchive::ShouldCompact(float MaxDeadRatio) const
+{
+	const int64 DeadBytes = FileSize - LiveBytes;
+	return DeadBytes > 0 && DeadBytes > LiveBytes * MaxDeadRatio;
+}
+
+bool FIndexedSaveArchive::ReadTableOfContents(IFileHandle& Handle, int64 FooterOffset)
+{
+	Entries.Reset();
+	LiveBytes = 0;
+
+	TArray<uint8> Footer;
+	Footer.SetNumUninitialized(IndexedSaveArchive::FooterSize);
+	if (FooterOffset < IndexedSaveArchive::HeaderSize || !Handle.Seek(FooterOffset) || !Handle.Read(Footer.GetData(), Footer.Num()))
+		return false;
+
+	int64 TocOffset = 0;
+	int64 TocSize = 0;
+	uint32 TocCrc = 0;
+	uint32 FooterMagic = 0;
+	FMemoryReader FooterReader(Footer);
+	FooterReader << TocOffset << TocSize << TocCrc << FooterMagic;
+
+	if (FooterMagic != IndexedSaveArchive::Magic || TocOffset < IndexedSaveArchive::HeaderSize || TocSize < sizeof(int32) || TocOffset + TocSize != FooterOffset)
+		return false;
+
+	TArray<uint8> Toc;
+	Toc.SetNumUninitialized(TocSize);
+	if (!Handle.Seek(TocOffset) || !Handle.Read(Toc.GetData(), Toc.Num()) || FCrc::MemCrc32(Toc.GetData(), Toc.Num()) != TocCrc)
+		return false;
+
+	FMemoryReader TocReader(Toc);
+	int32 NumEntries = 0;
+	TocReader << NumEntries;
+	Entries.Reserve(NumEntries);
+
+	for (int32 Index = 0; Index < NumEntries && !TocReader.IsError(); Index++)
+	{
+		FString Name;
+		FEntry Entry;
+		TocReader << Name << Entry.Offset << Entry.Size << Entry.Crc;
+
+		if (Entry.Offset < IndexedSaveArchive::HeaderSize || Entry.Size < 0 || Entry.Offset + Entry.Size > TocOffset)
+		{
+			Entries.Reset();
+			return false;
+		}
+		Entries.Add(MoveTemp(Name), Entry);
+	}
+
+	if (TocReader.IsError())
+	{
+		Entries.Reset();
+		return false;
+	}
+
+	UpdateLiveBytes();
+	return true;
+}
+
+bool FIndexedSaveArchive::FindLastValidFooter(IFileHandle& Handle)
+{
+	const uint32 Magic = IndexedSaveArchive::Magic;
+
+	TArray<uint8> Chunk;
+	int64 ChunkEnd = FileSize;
+	while (ChunkEnd > IndexedSaveArchive::HeaderSize)
+	{
+		const int64 ChunkStart = FMath::Max(IndexedSaveArchive::HeaderSize, ChunkEnd - IndexedSaveArchive::ScanChunkSize);
+		Chunk.SetNumUninitialized(ChunkEnd - ChunkStart);
+		if (!Handle.Seek(ChunkStart) || !Handle.Read(Chunk.GetData(), Chunk.Num()))
+			return false;
+
+		//The footer ends with the magic
+		for (int64 Index = Chunk.Num() - sizeof(uint32); Index >= 0; Index--)
+		{
+			if (FMemory::Memcmp(Chunk.GetData() + Index, &Magic, sizeof(uint32)) != 0)
+				continue;
+
+			const int64 FooterOffset = ChunkStart + Index + sizeof(uint32) - IndexedSaveArchive::FooterSize;
+			if (ReadTableOfContents(Handle, FooterOffset))
+				return true;
+		}
+
+		if (ChunkStart == IndexedSaveArchive::HeaderSize)
+			break;
+
+		//Overlap so a magic split between chunks is found
+		ChunkEnd = ChunkStart + sizeof(uint32) - 1;
+	}
+	return false;
+}
+
+bool FIndexedSaveArchive::WriteTableOfContents(IFileHandle& Handle, const TMap<FString, FEntry>& InEntries, int64 TocOffset) const
+{
+	TArray<uint8> Toc;
+	FMemoryWriter TocWriter(Toc);
+
+	int32 NumEntries = InEntries.Num();
+	TocWriter << NumEntries;
+	for (const auto& Pair : InEntries)
+	{
+		FString Name = Pair.Key;
+		FEntry Entry = Pair.Value;
+		TocWriter << Name << Entry.Offset << Entry.Size << Entry.Crc;
+	}
+
+	TArray<uint8> Footer;
+	FMemoryWriter FooterWriter(Footer);
+
+	int64 TocSize = Toc.Num();
+	uint32 TocCrc = FCrc::MemCrc32(Toc.GetData(), Toc.Num());
+	uint32 Magic = IndexedSaveArchive::Magic;
+	FooterWriter << TocOffset << TocSize << TocCrc << Magic;
+
+	return Handle.Write(Toc.GetData(), Toc.Num()) && Handle.Write(Footer.GetData(), Footer.Num());
+}
+
+bool FIndexedSaveArchive::ReadEntryFromHandle(IFileHandle& Handle, const FString& Name, const FEntry& Entry, TArray<uint8>& OutBytes) const
+{
+	OutBytes.SetNumUninitialized(Entry.Size);
+	if (!Handle.Seek(Entry.Offset) || !Handle.Read(OutBytes.GetData(), Entry.Size))
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to read %s from save archive %s"), *Name, *FilePath);
+		return false;
+	}
+
+	if (FCrc::MemCrc32(OutBytes.GetData(), OutBytes.Num()) != Entry.Crc)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Corrupt entry %s in save archive %s: Checksum mismatch"), *Name, *FilePath);
+		return false;
+	}
+	return true;
+}
+
+IFileHandle* FIndexedSaveArchive::GetReadHandle() const
+{
+	//Kept open so loading many entries only opens the file once
+	if (!ReadHandle)
+		ReadHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath));
+
+	if (!ReadHandle)
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to open save archive %s for reading"), *FilePath);
+
+	return ReadHandle.Get();
+}
+
+void FIndexedSaveArchive::UpdateLiveBytes()
+{
+	LiveBytes = 0;
+	for (const auto& Pair : Entries)
+	{
+		LiveBytes += Pair.Value.Size;
+	}
+}
@@ -4,16 +4,73 @@
 #include "SaveInterface.h"
 #include "Kismet/GameplayStatics.h"
 #include "EngineUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
 #include "SaveSettings.h"
 #include "Components/GameFrameworkComponent.h"
 #include "Constants/ConstantsDataAsset.h"
+#include "SaveObjects/IndexedSaveArchive.h"
+#include "SaveObjects/GeneralSaveGame.h"
 #include "SaveObjects/SoloSaveGame.h"
 
+#if PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
 DEFINE_LOG_CATEGORY(LogSaveSystem)
 
+static FAutoConsoleCommand BenchmarkCompressionCommand(
+	TEXT("SaveSystem.BenchmarkCompression"),
+	TEXT("Compares size and time of every save compression codec on a general save slot. Usage: SaveSystem.BenchmarkCompression <SlotName> [Iterations]"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.IsEmpty())
+		{
+			UE_LOG(LogSaveSystem, Warning, TEXT("BenchmarkCompression: Missing slot name."));
+			return;
+		}
+
+		UGeneralSaveGame* SaveGame = Cast<UGeneralSaveGame>(USaveSubSystem::LoadGameFromSlot(Args[0]));
+		if (!SaveGame)
+		{
+			UE_LOG(LogSaveSystem, Warning, TEXT("BenchmarkCompression: %s is not a general save slot."), *Args[0]);
+			return;
+		}
+
+		TArray<FObjectData> Samples;
+		SaveGame->GetAllData().GenerateValueArray(Samples);
+		const int32 Iterations = Args.IsValidIndex(1) ? FCString::Atoi(*Args[1]) : 1;
+
+		UE_LOG(LogSaveSystem, Log, TEXT("BenchmarkCompression: %s, %d objects, %d iterations"), *Args[0], Samples.Num(), Iterations);
+		for (const FSaveCompressionBenchmarkResult& Result : UGeneralSaveGame::BenchmarkCompression(Samples, Iterations))
+		{
+			UE_LOG(LogSaveSystem, Log, TEXT("%-8s %12lld -> %12lld bytes (%5.1f%%)  compress %8.3f ms  decompress %8.3f ms"),
+				*UEnum::GetDisplayValueAsText(Result.Codec).ToString(),
+				Result.UncompressedBytes, Result.CompressedBytes,
+				Result.UncompressedBytes > 0 ? 100.0 * Result.CompressedBytes / Result.UncompressedBytes : 100.0,
+				Result.CompressMs, Result.DecompressMs);
+		}
+	}));
+
 FString USaveSubSystem::SoloSaveDirectory = "";
 FString USaveSubSystem::SoloSaveName = "Solos";
 
+namespace SaveSlotHeader
+{
+	//"SSCK"
+	static constexpr uint32 Magic = 0x4B435353;
+	static constexpr uint32 Version = 2;
+	//Magic, Version, Payload Length, Payload CRC
+	static constexpr int32 SizeV1 = sizeof(uint32) + sizeof(uint32) + sizeof(int64) + sizeof(uint32);
+	//Version 2 adds the object count, so tools can show it without reading the payload
+	static constexpr int32 Size = SizeV1 + sizeof(int32);
+
+	static int32 GetSize(uint32 InVersion) { return InVersion >= 2 ? Size : SizeV1; }
+}
+
 USaveSubSystem* USaveSubSystem::Get()
 {
 	return GEngine->GetEngineSubsystem<USaveSubSystem>();
@@ -54,23 +111,44 @@ void USaveSubSystem::Deinitialize()
 
 	//Save Loaded Save Games
 	ReevaluateSolosForSave();
+	FlushSaveArchive();
+
+	if (ConstantsLoadHandle.IsValid())
+		ConstantsLoadHandle->CancelHandle();
 }
 
 void USaveSubSystem::Save(UObject* WorldContextObject, FGameplayTag SaveTag)
 {
+	DEBUG_SCOPE_TIMER(SaveTags::Name)
 	TArray<UObject*> ObjectsToSave = GetAllSaveObjects(WorldContextObject);
+	const bool bFullSave = IsFullSaveDue(SaveTag);
 	
-	FString DebugString = FString::Printf(TEXT("Requested type save for %s"), *SaveTag.GetTagName().ToString());
+	FString DebugString = FString::Printf(TEXT("Requested %s type save for %s"), bFullSave ? TEXT("full") : TEXT("incremental"), *SaveTag.GetTagName().ToString());
 	DEBUG_SIMPLE(LogSaveSystem, Log, FColor::White, *DebugString, SaveTags::Name)
 
+	//Incremental saves skip clean objects, full saves also catch changes that were not marked dirty
+	bFullTypeSave = bFullSave;
+	NumCleanObjects = 0;
+	NumUnchangedSlots = 0;
+	bBatchArchiveWrites = true;
 	for (auto Object : ObjectsToSave)
 	{
 		RequestSaveForObjectBySaveType(Object, SaveTag);
 	}
+	bBatchArchiveWrites = false;
+	bFullTypeSave = true;
+	FlushSaveArchive();
+
+	if (NumCleanObjects > 0 || NumUnchangedSlots > 0)
+	{
+		DebugString = FString::Printf(TEXT("Skipped %i clean objects and writing %i unchanged slots"), NumCleanObjects, NumUnchangedSlots);
+		DEBUG_SIMPLE(LogSaveSystem, Log, FColor::White, *DebugString, SaveTags::Name)
+	}
 }
 
 void USaveSubSystem::Load(UObject* WorldContextObject, FGameplayTag SaveTag)
 {
+	DEBUG_SCOPE_TIMER(SaveTags::Name)
 	TArray<UObject*> ObjectsToSave = GetAllSaveObjects(WorldContextObject);
 
 	FString DebugString = FString::Printf(TEXT("Requested type load for %s"), *SaveTag.GetTagName().ToString());
@@ -175,6 +253,22 @@ void USaveSubSystem::RequestClearForObjectBySaveType(UObject* Object, FGameplayT
 	ClearObject(Object, SaveType);
 }
 
+void USaveSubSystem::MarkObjectDirty(UObject* Object)
+{
+	CleanSaveTypes.Remove(Object);
+}
+
+void USaveSubSystem::MarkAllObjectsDirty()
+{
+	CleanSaveTypes.Reset();
+}
+
+bool USaveSubSystem::IsObjectDirty(UObject* Object, FGameplayTag SaveType) const
+{
+	const FGameplayTagContainer* CleanTypes = CleanSaveTypes.Find(Object);
+	return !CleanTypes || !CleanTypes->HasTagExact(SaveType);
+}
+
 void USaveSubSystem::SaveSoloFloat(FGameplayTag Tag, float Value)
 {
 	ReevaluateLoadedSolos();
@@ -348,6 +442,13 @@ FGameplayTagContainer USaveSubSystem::GetSupportedSaveTypes(UObject* Object) con
 
 void USaveSubSystem::SaveObject(UObject* Object, const FGameplayTag SaveType) const
 {
+	//Clean objects still match what they last saved or loaded
+	if (!bFullTypeSave && !IsObjectDirty(Object, SaveType))
+	{
+		NumCleanObjects++;
+		return;
+	}
+
 	FGameplayTag SaveTag {};
 	TSubclassOf<USaveGame> SaveClass = nullptr;
 	bool bValidCustomData = GetSaveIDs(Object, SaveTag, SaveClass);
@@ -361,7 +462,7 @@ void USaveSubSystem::SaveObject(UObject* Object, const FGameplayTag SaveType) co
 
 		//Loads in previous save if configured
 		if (USaveSettings::Get()->bLoadDataBeforeSave)
-			SaveObject = UGameplayStatics::LoadGameFromSlot(SaveName, 0);
+			SaveObject = ReadObjectSlot(SaveName);
 
 		if (!SaveObject)
 			SaveObject = UGameplayStatics::CreateSaveGameObject(SaveClass);
@@ -375,11 +476,38 @@ void USaveSubSystem::SaveObject(UObject* Object, const FGameplayTag SaveType) co
 	//Execute Interface
 	ISaveInterface::Execute_OnSave(Object, SaveObject, LoadedSolos, SaveType);
 
+	bool bSaved = true;
 	if (bValidCustomData)
 	{
-		UGameplayStatics::SaveGameToSlot(SaveObject, SaveName, 0);
+		TArray<uint8> Bytes;
+		if (!SaveObject || !UGameplayStatics::SaveGameToMemory(SaveObject, Bytes))
+		{
+			UE_LOG(LogSaveSystem, Error, TEXT("Failed to serialize save game for %s"), *SaveName);
+			bSaved = false;
+		}
+		else
+		{
+			//Dirty objects and full saves can still produce the bytes of the last write
+			const uint32 DataHash = FCrc::MemCrc32(Bytes.GetData(), Bytes.Num());
+			const uint32* WrittenHash = WrittenSlotHashes.Find(SaveName);
+			if (USaveSettings::Get()->bIncrementalSaves && WrittenHash && *WrittenHash == DataHash)
+			{
+				NumUnchangedSlots++;
+			}
+			else
+			{
+				bSaved = WriteObjectSlot(MoveTemp(Bytes), SaveName, GetSaveObjectCount(SaveObject));
+				if (bSaved)
+					WrittenSlotHashes.Add(SaveName, DataHash);
+				else
+					WrittenSlotHashes.Remove(SaveName);
+			}
+		}
 	}
 
+	if (bSaved)
+		CleanSaveTypes.FindOrAdd(Object).AddTag(SaveType);
+
 	//Save Solos if modified
 	ReevaluateSolosForSave();
 }
@@ -395,7 +523,7 @@ void USaveSubSystem::LoadObject(UObject* Object, const FGameplayTag SaveType) co
 
 	if (bValidCustomData)
 	{
-		SaveObject = UGameplayStatics::LoadGameFromSlot(SaveName, 0);
+		SaveObject = ReadObjectSlot(SaveName);
 		
 		FString DebugString = FString::Printf(TEXT("Object loaded from: %s for %s"), *SaveName, *Object->GetName());
 		DEBUG_SIMPLE(LogSaveSystem, Log, FColor::White, *DebugString, SaveTags::Name)
@@ -410,6 +538,12 @@ void USaveSubSystem::LoadObject(UObject* Object, const FGameplayTag SaveType) co
 	bool bValid = SaveObject != nullptr;
 	ISaveInterface::Execute_OnLoad(Object, SaveObject, LoadedSolos, SaveType, bValid);
 
+	//A loaded object matches its slot until it changes again
+	if (bValid || !bValidCustomData)
+		CleanSaveTypes.FindOrAdd(Object).AddTag(SaveType);
+	else
+		CleanSaveTypes.Remove(Object);
+
 	//Save Solos if Modified
 	ReevaluateSolosForSave();
 }
@@ -421,16 +555,38 @@ void USaveSubSystem::ClearObject(UObject* Object, const FGameplayTag SaveType) c
 	if (GetSaveIDs(Object, SaveTag, SaveClass))
 	{
 		FString SaveName = GetFullSaveName(SaveType, SaveTag);
-		UGameplayStatics::DeleteGameInSlot(SaveName, 0);
+		DeleteObjectSlot(SaveName);
+
+		if (FGameplayTagContainer* CleanTypes = CleanSaveTypes.Find(Object))
+			CleanTypes->RemoveTag(SaveType);
 		
 		FString DebugString = FString::Printf(TEXT("Object cleared: %s"), *SaveName);
 		DEBUG_SIMPLE(LogSaveSystem, Log, FColor::White, *DebugString, SaveTags::Name)
 	}
 }
 
+bool USaveSubSystem::IsFullSaveDue(FGameplayTag SaveType)
+{
+	const USaveSettings* SaveSettings = USaveSettings::Get();
+	if (!SaveSettings->bIncrementalSaves)
+		return true;
+
+	int32& SaveCount = IncrementalSaveCounts.FindOrAdd(SaveType);
+	if (SaveCount++ % FMath::Max(SaveSettings->FullSaveInterval, 1) != 0)
+		return false;
+
+	//Drop objects that no longer exist while everything gets written anyway
+	for (auto It = CleanSaveTypes.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+			It.RemoveCurrent();
+	}
+	return true;
+}
+
 USoloSaveGame* USaveSubSystem::LoadSolos()
 {
-	USaveGame* LoadedSave = UGameplayStatics::LoadGameFromSlot(GetSoloSaveName(), 0);
+	USaveGame* LoadedSave = LoadGameFromSlot(GetSoloSaveName());
 	USoloSaveGame* CastSave = Cast<USoloSaveGame>(LoadedSave);
 	if (!CastSave)
 	{
@@ -442,7 +598,7 @@ USoloSaveGame* USaveSubSystem::LoadSolos()
 
 bool USaveSubSystem::SaveSolos(USoloSaveGame* SoloToSave)
 {
-	return UGameplayStatics::SaveGameToSlot(SoloToSave, GetSoloSaveName(), 0);
+	return SaveGameToSlot(SoloToSave, GetSoloSaveName());
 }
 
 FString USaveSubSystem::GetSoloSaveName()
@@ -450,36 +606,414 @@ FString USaveSubSystem::GetSoloSaveName()
 	return SoloSaveDirectory + SoloSaveName;
 }
 
-TArray<UConstantConfigs*> USaveSubSystem::GetAllConfigsOfType(const TSubclassOf<UConstantConfigs>& Class)
+bool USaveSubSystem::SaveGameToSlot(USaveGame* SaveGame, const FString& SlotName)
 {
-#if WITH_EDITOR
-	LoadAllConstants();
+	TArray<uint8> Payload;
+	if (!SaveGame || !UGameplayStatics::SaveGameToMemory(SaveGame, Payload))
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to serialize save game for slot %s"), *SlotName);
+		return false;
+	}
+
+	return SaveBytesToSlot(Payload, SlotName, GetSaveObjectCount(SaveGame));
+}
+
+bool USaveSubSystem::SaveBytesToSlot(const TArray<uint8>& Payload, const FString& SlotName, int32 ObjectCount)
+{
+	TArray<uint8> FileBytes;
+	FileBytes.Reserve(SaveSlotHeader::Size + Payload.Num());
+	FMemoryWriter Writer(FileBytes);
+	
+	uint32 Magic = SaveSlotHeader::Magic;
+	uint32 Version = SaveSlotHeader::Version;
+	int64 PayloadLength = Payload.Num();
+	uint32 PayloadCrc = FCrc::MemCrc32(Payload.GetData(), Payload.Num());
+	Writer << Magic << Version << PayloadLength << PayloadCrc << ObjectCount;
+	Writer.Serialize(Payload.GetData(), Payload.Num());
+
+	const USaveSettings* SaveSettings = USaveSettings::Get();
+	const FString FilePath = GetSlotFilePath(SlotName);
+	
+	bool bSuccess;
+	if (SaveSettings->bAtomicSaveWrites)
+		bSuccess = WriteFileAtomic(FileBytes, FilePath, SaveSettings->bKeepBackupSlots);
+	else
+		bSuccess = FFileHelper::SaveArrayToFile(FileBytes, *FilePath);
+
+	if (!bSuccess)
+		UE_LOG(LogSaveSystem, Error, TEXT("Failed to write save slot %s"), *FilePath);
+	
+	return bSuccess;
+}
+
+USaveGame* USaveSubSystem::LoadGameFromSlot(const FString& SlotName)
+{
+	const FString FilePath = GetSlotFilePath(SlotName);
+	
+	bool bCorrupt = false;
+	if (USaveGame* SaveGame = LoadGameFromFile(FilePath, bCorrupt))
+		return SaveGame;
+
+	const FString BackupPath = FilePath + TEXT(".bak");
+	if (!USaveSettings::Get()->bFallbackToBackupSlot || !IFileManager::Get().FileExists(*BackupPath))
+		return nullptr;
+
+	//A missing slot with a backup means the slot was lost after its last successful write
+	if (!bCorrupt && IFileManager::Get().FileExists(*FilePath))
+		return nullptr;
+	
+	UE_LOG(LogSaveSystem, Warning, TEXT("Loading previous copy of save slot %s"), *SlotName);
+
+	bool bBackupCorrupt = false;
+	return LoadGameFromFile(BackupPath, bBackupCorrupt);
+}
+
+bool USaveSubSystem::DeleteGameInSlot(const FString& SlotName)
+{
+	const FString FilePath = GetSlotFilePath(SlotName);
+	IFileManager::Get().Delete(*(FilePath + TEXT(".bak")), false, true, true);
+	return IFileManager::Get().Delete(*FilePath, false, true, true);
+}
+
+FString USaveSubSystem::GetSlotFilePath(const FString& SlotName)
+{
+	//Same location the generic platform save system uses
+	return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), SlotName + TEXT(".sav"));
+}
+
+USaveGame* USaveSubSystem::LoadGameFromFile(const FString& FilePath, bool& bOutCorrupt)
+{
+	TArray<uint8> Payload;
+	if (!ReadVerifiedSlotFile(FilePath, Payload, bOutCorrupt))
+		return nullptr;
+
+	USaveGame* SaveGame = UGameplayStatics::LoadGameFromMemory(Payload);
+	bOutCorrupt = SaveGame == nullptr;
+	return SaveGame;
+}
+
+bool USaveSubSystem::ReadVerifiedSlotFile(const FString& FilePath, TArray<uint8>& OutPayload, bool& bOutCorrupt)
+{
+	bOutCorrupt = false;
+	
+	if (!IFileManager::Get().FileExists(*FilePath) || !FFileHelper::LoadFileToArray(OutPayload, *FilePath))
+		return false;
+
+	uint32 Magic = 0;
+	if (OutPayload.Num() >= sizeof(uint32))
+		FMemory::Memcpy(&Magic, OutPayload.GetData(), sizeof(uint32));
+
+	//Written before slot headers existed
+	if (Magic != SaveSlotHeader::Magic)
+		return true;
+
+	bOutCorrupt = true;
+	if (OutPayload.Num() < SaveSlotHeader::SizeV1)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Corrupt save slot %s: File is smaller than its header"), *FilePath);
+		return false;
+	}
+
+	FMemoryReader Reader(OutPayload);
+	uint32 Version = 0;
+	int64 PayloadLength = 0;
+	uint32 PayloadCrc = 0;
+	Reader << Magic << Version << PayloadLength << PayloadCrc;
+
+	if (Version > SaveSlotHeader::Version)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Save slot %s has unsupported header version %u"), *FilePath, Version);
+		return false;
+	}
+
+	const int32 HeaderSize = SaveSlotHeader::GetSize(Version);
+	if (PayloadLength != OutPayload.Num() - HeaderSize)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Corrupt save slot %s: Expected %lld bytes, found %d"), *FilePath, PayloadLength, OutPayload.Num() - HeaderSize);
+		return false;
+	}
+
+	const uint32 FoundCrc = FCrc::MemCrc32(OutPayload.GetData() + HeaderSize, PayloadLength);
+	if (FoundCrc != PayloadCrc)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Corrupt save slot %s: Checksum mismatch"), *FilePath);
+		return false;
+	}
+
+	OutPayload.RemoveAt(0, HeaderSize, EAllowShrinking::No);
+	bOutCorrupt = false;
+	return true;
+}
+
+bool USaveSubSystem::ReadSlotObjectCount(const FString& FilePath, int32& OutObjectCount)
+{
+	OutObjectCount = INDEX_NONE;
+
+	TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath));
+	if (!Handle || Handle->Size() < SaveSlotHeader::Size)
+		return false;
+
+	TArray<uint8> HeaderBytes;
+	HeaderBytes.SetNumUninitialized(SaveSlotHeader::Size);
+	if (!Handle->Read(HeaderBytes.GetData(), HeaderBytes.Num()))
+		return false;
+
+	FMemoryReader Reader(HeaderBytes);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	int64 PayloadLength = 0;
+	uint32 PayloadCrc = 0;
+	Reader << Magic << Version << PayloadLength << PayloadCrc;
+
+	//Older headers and legacy slots do not store the count
+	if (Magic != SaveSlotHeader::Magic || Version < 2 || Version > SaveSlotHeader::Version)
+		return false;
+
+	Reader << OutObjectCount;
+	return !Reader.IsError() && OutObjectCount != INDEX_NONE;
+}
+
+int32 USaveSubSystem::GetSaveObjectCount(const USaveGame* SaveGame)
+{
+	const UGeneralSaveGame* GeneralSave = Cast<UGeneralSaveGame>(SaveGame);
+	return GeneralSave ? GeneralSave->GetNumData() : INDEX_NONE;
+}
+
+bool USaveSubSystem::WriteFileAtomic(const TArray<uint8>& Bytes, const FString& FilePath, bool bKeepBackup)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const FString TempPath = FilePath + TEXT(".tmp");
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+
+	//The temp file has to be on disk before it replaces the slot
+	{
+		TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*TempPath));
+		if (!Handle || !Handle->Write(Bytes.GetData(), Bytes.Num()) || !Handle->Flush(true))
+		{
+			Handle.Reset();
+			PlatformFile.DeleteFile(*TempPath);
+			return false;
+		}
+	}
+
+	//Copied instead of moved so the slot itself is never missing
+	if (bKeepBackup && PlatformFile.FileExists(*FilePath))
+		IFileManager::Get().Copy(*(FilePath + TEXT(".bak")), *FilePath, true, true);
+
+	if (!ReplaceFile(FilePath, TempPath))
+	{
+		PlatformFile.DeleteFile(*TempPath);
+		return false;
+	}
+	return true;
+}
+
+bool USaveSubSystem::ReplaceFile(const FString& DestPath, const FString& SourcePath)
+{
+#if PLATFORM_WINDOWS
+	const FString FullDestPath = FPaths::ConvertRelativePathToFull(DestPath);
+	const FString FullSourcePath = FPaths::ConvertRelativePathToFull(SourcePath);
+	return MoveFileExW(*FullSourcePath, *FullDestPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	//Platform file moves are a rename, which replaces an existing destination in one step
+	return FPlatformFileManager::Get().GetPlatformFile().MoveFile(*DestPath, *SourcePath);
 #endif
+}
+
+bool USaveSubSystem::WriteObjectSlot(TArray<uint8>&& Bytes, const FString& SaveName, int32 ObjectCount) const
+{
+	FIndexedSaveArchive* Archive = GetSaveArchive();
+	if (!Archive)
+		return SaveBytesToSlot(Bytes, SaveName, ObjectCount);
+
+	Archive->WriteEntry(SaveName, MoveTemp(Bytes));
+	if (!bBatchArchiveWrites)
+		FlushSaveArchive();
+	return true;
+}
+
+USaveGame* USaveSubSystem::ReadObjectSlot(const FString& SaveName) const
+{
+	FIndexedSaveArchive* Archive = GetSaveArchive();
+	if (!Archive || !Archive->HasEntry(SaveName))
+		return LoadGameFromSlot(SaveName);
+
+	TArray<uint8> Bytes;
+	if (!Archive->ReadEntry(SaveName, Bytes))
+		return nullptr;
 	
-	TArray<UConstantConfigs*> Configs {};
-	for (auto Constant : Constants)
+	return UGameplayStatics::LoadGameFromMemory(Bytes);
+}
+
+void USaveSubSystem::DeleteObjectSlot(const FString& SaveName) const
+{
+	WrittenSlotHashes.Remove(SaveName);
+
+	if (FIndexedSaveArchive* Archive = GetSaveArchive())
 	{
-		Configs.Append(Constant->GetAllConfigsOfType(Class));
+		Archive->RemoveEntry(SaveName);
+		if (!bBatchArchiveWrites)
+			FlushSaveArchive();
 	}
+
+	DeleteGameInSlot(SaveName);
+}
+
+FIndexedSaveArchive* USaveSubSystem::GetSaveArchive() const
+{
+	const USaveSettings* SaveSettings = USaveSettings::Get();
+	if (!SaveSettings->bUseSaveArchive)
+		return nullptr;
+
+	const FString FilePath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames"), SaveSettings->SaveArchiveName + TEXT(".sarc"));
+	if (!SaveArchive || SaveArchive->GetFilePath() != FilePath)
+	{
+		SaveArchive = MakeShared<FIndexedSaveArchive>(FilePath);
+		
+		//A broken archive is left untouched, objects fall back to their slot files
+		if (!SaveArchive->Open())
+			UE_LOG(LogSaveSystem, Error, TEXT("Save archive %s could not be opened, using slot files instead"), *FilePath);
+	}
+
+	return SaveArchive->IsOpen() ? SaveArchive.Get() : nullptr;
+}
+
+void USaveSubSystem::FlushSaveArchive() const
+{
+	if (!SaveArchive || !SaveArchive->IsOpen())
+		return;
+
+	SaveArchive->Flush();
+	if (SaveArchive->ShouldCompact(USaveSettings::Get()->SaveArchiveCompactionRatio))
+		SaveArchive->Compact();
+}
+
+bool USaveSubSystem::CompactSaveArchive()
+{
+	FIndexedSaveArchive* Archive = GetSaveArchive();
+	return Archive && Archive->Compact();
+}
+
+TArray<UConstantConfigs*> USaveSubSystem::GetAllConfigsOfType(const TSubclassOf<UConstantConfigs>& Class)
+{
+	TArray<UConstantConfigs*> Configs {};
+	VisitConfigsOfType(Class, [&Configs](UConstantConfigs* Config)
+	{
+		Configs.Add(Config);
+		return false;
+	});
 	return Configs;
 }
 
-void USaveSubSystem::LoadAllConstants()
+bool USaveSubSystem::VisitConfigsOfType(const TSubclassOf<UConstantConfigs>& Class, TFunctionRef<bool(UConstantConfigs*)> Visitor)
+{
+#if WITH_EDITOR
+	LoadAllConstants(true);
+#endif
+
+	auto VisitAsset = [&Class, &Visitor](const UConstantsDataAsset* Asset)
+	{
+		if (!Asset)
+			return false;
+		
+		for (UConstantConfigs* Config : Asset->GetAllConfigsOfType(Class))
+		{
+			if (Visitor(Config))
+				return true;
+		}
+		return false;
+	};
+
+	if (bConstantsReady)
+	{
+		for (const UConstantsDataAsset* Asset : Constants)
+		{
+			if (VisitAsset(Asset))
+				return true;
+		}
+		return false;
+	}
+
+	//Still preloading, only the definitions the lookup reaches are loaded
+	for (const TSoftObjectPtr<UConstantsDataAsset>& Definition : USaveSettings::Get()->ConstantDefinitions)
+	{
+		if (VisitAsset(GetConstantsAssetForLookup(Definition)))
+			return true;
+	}
+	return false;
+}
+
+void USaveSubSystem::LoadAllConstants(bool bForceSynchronous)
 {
 	USaveSettings* SaveSettings = USaveSettings::Get();
 	if (!SaveSettings)
 		return;
 
-	Constants.Empty();
+	if (!bConstantsReady)
+		ConstantsLoadStartTime = FPlatformTime::Seconds();
+	
+	if (SaveSettings->bAsyncPreloadConstants && !bForceSynchronous)
+	{
+		TArray<FSoftObjectPath> Paths;
+		for (const TSoftObjectPtr<UConstantsDataAsset>& Definition : SaveSettings->ConstantDefinitions)
+		{
+			if (!Definition.IsNull())
+				Paths.Add(Definition.ToSoftObjectPath());
+		}
+
+		bConstantsReady = false;
+		ConstantsLoadHandle = ConstantsStreamableManager.RequestAsyncLoad(Paths, FStreamableDelegate::CreateUObject(this, &USaveSubSystem::OnConstantsLoaded));
+		if (!ConstantsLoadHandle.IsValid())
+			OnConstantsLoaded();
+		return;
+	}
+
 	for (auto ConstantDefinitions : SaveSettings->ConstantDefinitions)
 	{
-		UConstantsDataAsset* Asset = ConstantDefinitions.LoadSynchronous();
+		ConstantDefinitions.LoadSynchronous();
+	}
+	OnConstantsLoaded();
+}
 
-		if (!Asset)
-			continue;
+void USaveSubSystem::OnConstantsLoaded()
+{
+	USaveSettings* SaveSettings = USaveSettings::Get();
 
-		Constants.Add(Asset);
+	//Keeps the definition order, it decides which constant wins
+	Constants.Empty();
+	for (const TSoftObjectPtr<UConstantsDataAsset>& Definition : SaveSettings->ConstantDefinitions)
+	{
+		if (UConstantsDataAsset* Asset = Definition.Get())
+			Constants.Add(Asset);
 	}
+
+	if (bConstantsReady)
+		return;
+
+	bConstantsReady = true;
+	ConstantsLoadTimeMs = (FPlatformTime::Seconds() - ConstantsLoadStartTime) * 1000.0;
+
+	UE_LOG(LogSaveSystem, Log, TEXT("Constants ready after %.2f ms (%d definitions, %s)"), ConstantsLoadTimeMs, Constants.Num(),
+		ConstantsLoadHandle.IsValid() ? TEXT("async preload") : TEXT("synchronous"));
+	OnConstantsReady.Broadcast();
+}
+
+UConstantsDataAsset* USaveSubSystem::GetConstantsAssetForLookup(const TSoftObjectPtr<UConstantsDataAsset>& Definition) const
+{
+	if (UConstantsDataAsset* Asset = Definition.Get())
+		return Asset;
+
+	if (Definition.IsNull())
+		return nullptr;
+
+	if (!USaveSettings::Get()->bBlockOnConstantsNotReady)
+	{
+		UE_LOG(LogSaveSystem, Error, TEXT("Constants lookup before %s finished loading. Wait for OnConstantsReady or enable blocking lookups."), *Definition.ToString());
+		return nullptr;
+	}
+
+	UE_LOG(LogSaveSystem, Warning, TEXT("Constants lookup before %s finished loading, loading it synchronously."), *Definition.ToString());
+	return Definition.LoadSynchronous();
 }
 
 void USaveSubSystem::VerifyAllConstants()
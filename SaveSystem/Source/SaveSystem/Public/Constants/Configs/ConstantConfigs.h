@@ -60,15 +60,11 @@ T UConstantConfigs::GetConstantData(FGameplayTag Tag, TSubclassOf<UConstantConfi
 		return T();
 	
 	USaveSubSystem* System = USaveSubSystem::Get();
-	TArray<UConstantConfigs*> Configs = System->GetAllConfigsOfType(Class);
 
-	for (auto Config : Configs)
+	T Data {};
+	if (System->VisitConfigsOfType(Class, [&Tag, &Data](UConstantConfigs* Config) { return Config->GetData<T>(Tag, Data); }))
 	{
-		T Data {};
-		if (Config->GetData<T>(Tag, Data))
-		{
-			return Data;
-		}
+		return Data;
 	}
 	UE_LOG(LogTemp, Error, TEXT("Constant with tag -%s- not found!"), *Tag.GetTagName().ToString())
 	return T();
@@ -6,8 +6,50 @@
 #include "Save/ObjectSerializationLibrary.h"
 #include "GeneralSaveGame.generated.h"
 
+UENUM(BlueprintType)
+enum class ESaveCompressionCodec : uint8
+{
+	None,
+	Zlib,
+	//Falls back to Zlib if Oodle is not available on the platform
+	Oodle,
+};
+
+//FObjectData with compressed bytes, only used inside UGeneralSaveGame
+USTRUCT()
+struct FCompressedObjectData
+{
+	GENERATED_BODY()
+
+	UPROPERTY(SaveGame)
+	TSubclassOf<UObject> ObjectClass;
+	UPROPERTY(SaveGame)
+	ESaveCompressionCodec Codec = ESaveCompressionCodec::None;
+	UPROPERTY(SaveGame)
+	int32 UncompressedSize = 0;
+	UPROPERTY(SaveGame)
+	TArray<uint8> Data;
+};
+
+USTRUCT(BlueprintType)
+struct FSaveCompressionBenchmarkResult
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+	ESaveCompressionCodec Codec = ESaveCompressionCodec::None;
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+	int64 UncompressedBytes = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+	int64 CompressedBytes = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+	double CompressMs = 0;
+	UPROPERTY(BlueprintReadOnly, Category = "Save")
+	double DecompressMs = 0;
+};
+
 /**
- * 
+ *
  */
 UCLASS()
 class SAVESYSTEM_API UGeneralSaveGame : public USaveGame
@@ -16,17 +58,52 @@ class SAVESYSTEM_API UGeneralSaveGame : public USaveGame
 
 public:
 
+	UGeneralSaveGame();
+
+	//Saves before compression support have version 0
+	static constexpr int32 LatestSaveVersion = 1;
+
+	//Uses the slot compression
 	UFUNCTION(BlueprintCallable)
 	void AddData(FGameplayTag Tag, FObjectData Data);
 	UFUNCTION(BlueprintCallable)
+	void AddDataWithCompression(FGameplayTag Tag, FObjectData Data, ESaveCompressionCodec Codec);
+	UFUNCTION(BlueprintCallable)
 	bool RemoveData(FGameplayTag Tag);
 	UFUNCTION(BlueprintCallable)
 	bool GetData(FGameplayTag Tag, FObjectData& Data);
 	UFUNCTION(BlueprintCallable)
 	TMap<FGameplayTag, FObjectData> GetAllData();
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	int32 GetNumData() const { return TagDataPairs.Num() + CompressedTagDataPairs.Num(); }
+
+	UFUNCTION(BlueprintCallable)
+	void SetSlotCompression(ESaveCompressionCodec Codec) { SlotCompression = Codec; }
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	ESaveCompressionCodec GetSlotCompression() const { return SlotCompression; }
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	int32 GetSaveVersion() const { return SaveVersion; }
+
+	//Compresses and decompresses the data with every codec and reports size and time
+	UFUNCTION(BlueprintCallable)
+	static TArray<FSaveCompressionBenchmarkResult> BenchmarkCompression(const TArray<FObjectData>& Samples, int32 Iterations = 1);
+
+	static bool CompressBytes(ESaveCompressionCodec Codec, const TArray<uint8>& InBytes, TArray<uint8>& OutBytes);
+	static bool DecompressBytes(ESaveCompressionCodec Codec, const TArray<uint8>& InBytes, int32 UncompressedSize, TArray<uint8>& OutBytes);
 
 protected:
 
+	//The codec actually used, entries record this so they load on any platform that supports it
+	static ESaveCompressionCodec ResolveCodec(ESaveCompressionCodec Codec);
+	static FName GetFormatName(ESaveCompressionCodec Codec);
+
 	UPROPERTY(SaveGame)
 	TMap<FGameplayTag, FObjectData> TagDataPairs;
+	UPROPERTY(SaveGame)
+	TMap<FGameplayTag, FCompressedObjectData> CompressedTagDataPairs;
+
+	UPROPERTY(SaveGame)
+	ESaveCompressionCodec SlotCompression = ESaveCompressionCodec::None;
+	UPROPERTY(SaveGame)
+	int32 SaveVersion = 0;
 };
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+
+/**
+ * Single file container for many save slots, keyed by their full save name.
+ * Updates are only ever appended to the file, followed by a new table of contents. Compact rewrites only the live entries.
+ */
+class SAVESYSTEM_API FIndexedSaveArchive
+{
+public:
+
+	explicit FIndexedSaveArchive(const FString& InFilePath) : FilePath(InFilePath) {  }
+
+	//Reads only the table of contents, entries are read on demand
+	bool Open();
+	bool IsOpen() const { return bOpen; }
+
+	bool HasEntry(const FString& Name) const;
+	bool ReadEntry(const FString& Name, TArray<uint8>& OutBytes) const;
+	//Written entries and removals are visible right away and stored on the next flush
+	void WriteEntry(const FString& Name, TArray<uint8> Bytes);
+	void RemoveEntry(const FString& Name);
+	bool Flush();
+
+	bool Compact();
+	//True once the bytes of outdated entries exceed the live bytes times the ratio
+	bool ShouldCompact(float MaxDeadRatio) const;
+
+	int32 GetNumEntries() const { return Entries.Num(); }
+	int64 GetFileSize() const { return FileSize; }
+	const FString& GetFilePath() const { return FilePath; }
+
+private:
+
+	struct FEntry
+	{
+		int64 Offset = 0;
+		int64 Size = 0;
+		uint32 Crc = 0;
+	};
+
+	bool ReadTableOfContents(IFileHandle& Handle, int64 FooterOffset);
+	bool FindLastValidFooter(IFileHandle& Handle);
+	bool WriteTableOfContents(IFileHandle& Handle, const TMap<FString, FEntry>& InEntries, int64 TocOffset) const;
+	bool ReadEntryFromHandle(IFileHandle& Handle, const FString& Name, const FEntry& Entry, TArray<uint8>& OutBytes) const;
+	IFileHandle* GetReadHandle() const;
+	void UpdateLiveBytes();
+
+	FString FilePath;
+	TMap<FString, FEntry> Entries;
+	TMap<FString, TArray<uint8>> StagedEntries;
+	TSet<FString> StagedRemovals;
+
+	int64 FileSize = 0;
+	int64 LiveBytes = 0;
+	bool bOpen = false;
+
+	mutable TUniquePtr<IFileHandle> ReadHandle;
+};
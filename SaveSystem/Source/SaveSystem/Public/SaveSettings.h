@@ -3,6 +3,7 @@
 #include "CoreMinimal.h"
 #include "GameplayTagContainer.h"
 #include "Engine/DeveloperSettings.h"
+#include "SaveObjects/GeneralSaveGame.h"
 #include "Structs/TimeData.h"
 #include "SaveSettings.generated.h"
 
@@ -23,6 +24,34 @@ public:
 	FTimeData MinLoadTime = 3;
 	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save")
 	bool bLoadDataBeforeSave = false;
+	//Compression of new UGeneralSaveGame slots, saves without compression still load
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save")
+	ESaveCompressionCodec DefaultSaveCompression = ESaveCompressionCodec::None;
+	//Writes slots to a temporary file first and renames it once the write succeeded
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save")
+	bool bAtomicSaveWrites = true;
+	//Stores object saves as entries of a single indexed archive instead of one slot file each.
+	//Objects without an archive entry are still loaded from their slot file.
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save|Archive")
+	bool bUseSaveArchive = false;
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save|Archive", meta = (EditCondition = "bUseSaveArchive"))
+	FString SaveArchiveName = "SaveArchive";
+	//Compacts the archive once outdated entries take up more than this ratio of the live entries
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save|Archive", meta = (EditCondition = "bUseSaveArchive", ClampMin = 0))
+	float SaveArchiveCompactionRatio = 1.f;
+	//Type saves skip objects that were not marked dirty since they were last saved or loaded for that type.
+	//Changes have to be reported with MarkObjectDirty, otherwise they are only saved by the next full save.
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save|Incremental")
+	bool bIncrementalSaves = false;
+	//Every Nth type save saves all objects, clean or not, but only writes the slots whose data changed
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save|Incremental", meta = (EditCondition = "bIncrementalSaves", ClampMin = 1))
+	int32 FullSaveInterval = 10;
+	//Keeps the previous copy of a slot when overwriting it, requires atomic writes
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save", meta = (EditCondition = "bAtomicSaveWrites"))
+	bool bKeepBackupSlots = true;
+	//Loads the previous copy if a slot is missing or fails verification
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save", meta = (EditCondition = "bKeepBackupSlots"))
+	bool bFallbackToBackupSlot = true;
 
 	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Save", meta = (ForceInlineRow))
 	TMap<FGameplayTag, FString> DefaultStringSolos;
@@ -31,4 +60,10 @@ public:
 
 	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Constants")
 	TArray<TSoftObjectPtr<UConstantsDataAsset>> ConstantDefinitions {};
+	//Streams the constant definitions in the background instead of loading them during subsystem initialization
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Constants")
+	bool bAsyncPreloadConstants = true;
+	//Lookups before the preload finished load only the definitions they need synchronously, otherwise they fail
+	UPROPERTY(BlueprintReadOnly, Config, EditAnywhere, Category = "Constants", meta = (EditCondition = "bAsyncPreloadConstants"))
+	bool bBlockOnConstantsNotReady = true;
 };
@@ -2,9 +2,11 @@
 
 #include "CoreMinimal.h"
 #include "SaveTags.h"
+#include "Engine/StreamableManager.h"
 #include "Subsystems/GameInstanceSubsystem.h"
 #include "SaveSubSystem.generated.h"
 
+class FIndexedSaveArchive;
 class UConstantConfigs;
 class UConstantsDataAsset;
 class USoloSaveGame;
@@ -13,6 +15,7 @@ class UGeneralSaveGame;
 struct FGameplayTag;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogSaveSystem, Log, All);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnConstantsReady);
 /**
  * 
  */
@@ -50,6 +53,14 @@ public:
 	UFUNCTION(BlueprintCallable)
 	void RequestClearForObjectBySaveType(UObject* Object, UPARAM(meta = (Categories = "Save.Type")) FGameplayTag SaveType);
 
+	//Dirty Tracking - only used with incremental saves, objects are clean once saved or loaded until marked dirty
+	UFUNCTION(BlueprintCallable)
+	void MarkObjectDirty(UObject* Object);
+	UFUNCTION(BlueprintCallable)
+	void MarkAllObjectsDirty();
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool IsObjectDirty(UObject* Object, UPARAM(meta = (Categories = "Save.Type")) FGameplayTag SaveType) const;
+
 #pragma region Solos
 	UFUNCTION(BlueprintCallable)
 	void SaveSoloFloat(FGameplayTag Tag, float Value);
@@ -69,18 +80,78 @@ public:
 	static bool SaveSolos(USoloSaveGame* SoloToSave);
 	static FString GetSoloSaveName();
 #pragma endregion
+
+#pragma region Slots
+	//Slots are written with a length and checksum header that is verified before deserialization.
+	//Files without the header are loaded the legacy way.
+	static bool SaveGameToSlot(USaveGame* SaveGame, const FString& SlotName);
+	static USaveGame* LoadGameFromSlot(const FString& SlotName);
+	static bool DeleteGameInSlot(const FString& SlotName);
+	static FString GetSlotFilePath(const FString& SlotName);
+	//Reads and verifies a slot file without deserializing it, safe to call off the game thread
+	static bool ReadVerifiedSlotFile(const FString& FilePath, TArray<uint8>& OutPayload, bool& bOutCorrupt);
+	//Only reads the slot header, false if the slot does not store its object count
+	static bool ReadSlotObjectCount(const FString& FilePath, int32& OutObjectCount);
+	//Replaces DestPath with SourcePath in a single step, DestPath never goes missing in between
+	static bool ReplaceFile(const FString& DestPath, const FString& SourcePath);
+	
+protected:
+	
+	static USaveGame* LoadGameFromFile(const FString& FilePath, bool& bOutCorrupt);
+	static bool WriteFileAtomic(const TArray<uint8>& Bytes, const FString& FilePath, bool bKeepBackup);
+
+	static bool SaveBytesToSlot(const TArray<uint8>& Payload, const FString& SlotName, int32 ObjectCount);
+	//Number of entries stored in the header, INDEX_NONE for save games without a count
+	static int32 GetSaveObjectCount(const USaveGame* SaveGame);
+
+	//Object slots go through the save archive if enabled
+	bool WriteObjectSlot(TArray<uint8>&& Bytes, const FString& SaveName, int32 ObjectCount) const;
+	USaveGame* ReadObjectSlot(const FString& SaveName) const;
+	void DeleteObjectSlot(const FString& SaveName) const;
+	
+	FIndexedSaveArchive* GetSaveArchive() const;
+	void FlushSaveArchive() const;
+
+	mutable TSharedPtr<FIndexedSaveArchive> SaveArchive;
+	//Type saves flush the archive once at the end
+	mutable bool bBatchArchiveWrites = false;
+
+public:
+	UFUNCTION(BlueprintCallable)
+	bool CompactSaveArchive();
+#pragma endregion
 	
 #pragma region Constants
 	
 	TArray<UConstantConfigs*> GetAllConfigsOfType(const TSubclassOf<UConstantConfigs>& Class);
+	//Visits the configs of the class in definition order until the visitor returns true.
+	//Before the constants are ready only the definitions up to the match are loaded.
+	bool VisitConfigsOfType(const TSubclassOf<UConstantConfigs>& Class, TFunctionRef<bool(UConstantConfigs*)> Visitor);
+
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	bool AreConstantsReady() const { return bConstantsReady; }
+	//Time from the start of loading the constants until they were ready
+	UFUNCTION(BlueprintCallable, BlueprintPure)
+	float GetConstantsLoadTimeMs() const { return ConstantsLoadTimeMs; }
+
+	UPROPERTY(BlueprintAssignable)
+	FOnConstantsReady OnConstantsReady;
 
 protected:
 
-	void LoadAllConstants();
+	void LoadAllConstants(bool bForceSynchronous = false);
+	void OnConstantsLoaded();
 	void VerifyAllConstants();
+	UConstantsDataAsset* GetConstantsAssetForLookup(const TSoftObjectPtr<UConstantsDataAsset>& Definition) const;
 
 	UPROPERTY(Transient)
 	TArray<TObjectPtr<UConstantsDataAsset>> Constants {};
+
+	FStreamableManager ConstantsStreamableManager;
+	TSharedPtr<FStreamableHandle> ConstantsLoadHandle;
+	bool bConstantsReady = false;
+	double ConstantsLoadStartTime = 0;
+	float ConstantsLoadTimeMs = 0;
 	
 #pragma endregion
 	
@@ -99,6 +170,17 @@ protected:
 	void LoadObject(UObject* Object, FGameplayTag SaveType) const;
 	void ClearObject(UObject* Object, FGameplayTag SaveType) const;
 
+	bool IsFullSaveDue(FGameplayTag SaveType);
+
+	//Save types each object was last saved or loaded with and not marked dirty since
+	mutable TMap<TWeakObjectPtr<UObject>, FGameplayTagContainer> CleanSaveTypes;
+	TMap<FGameplayTag, int32> IncrementalSaveCounts;
+	//Hash of the bytes last written to each object slot, clean objects are only written again if theirs differ
+	mutable TMap<FString, uint32> WrittenSlotHashes;
+	mutable bool bFullTypeSave = true;
+	mutable int32 NumCleanObjects = 0;
+	mutable int32 NumUnchangedSlots = 0;
+
 	UPROPERTY(Transient)
 	mutable TObjectPtr<USoloSaveGame> LoadedSolos = nullptr;
 
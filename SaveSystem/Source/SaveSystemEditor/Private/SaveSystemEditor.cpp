@@ -1,13 +1,25 @@
 ﻿#include "SaveSystemEditor.h"
 
+#include "Async/Async.h"
+#include "HAL/FileManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "SaveSystem/Public/SaveSubSystem.h"
+#include "SaveSystem/Public/SaveObjects/GeneralSaveGame.h"
 #include "SaveSystem/Public/SaveObjects/SoloSaveGame.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Layout/SSplitter.h"
+#include "Widgets/Views/SListView.h"
 
 #define LOCTEXT_NAMESPACE "FSaveSystemEditorModule"
 
 const FName FSaveSystemEditorModule::SaveEditorTabName = "Save Editor";
 
+namespace SaveEditor
+{
+	//Files handed to the game thread at once while scanning
+	static constexpr int32 ScanBatchSize = 256;
+}
+
 void FSaveSystemEditorModule::StartupModule()
 {
 	FGlobalTabmanager::Get()->RegisterNomadTabSpawner(
@@ -21,65 +33,229 @@ void FSaveSystemEditorModule::StartupModule()
 void FSaveSystemEditorModule::ShutdownModule()
 {
 	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(SaveEditorTabName);
+
+	//Pending background work checks this before touching the module
+	ScanGeneration.Reset();
 }
 
-TArray<FName> FSaveSystemEditorModule::GetAllOptions() const
+void FSaveSystemEditorModule::RefreshAllData()
 {
-	TArray<FName> AllOptions {};
-	
+	const int32 Generation = ScanGeneration->Increment();
+	TWeakPtr<FThreadSafeCounter> WeakGeneration = ScanGeneration;
+
+	//Filter results computed against the previous list are dropped
+	++FilterGeneration;
+	AllSaveFiles.Reset();
+	FilteredSaveFiles.Reset();
+	bScanning = true;
+	if (SaveListView.IsValid())
+		SaveListView->RequestListRefresh();
+
 	const FString SaveDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("SaveGames/"));
-	
-	TArray<FString> FoundFiles;
-	IFileManager::Get().FindFilesRecursive(
-		FoundFiles,
-		*SaveDir,
-		TEXT("*.sav"),
-		/*Files=*/true,
-		/*Directories=*/false
-	);
-	
-	for (const FString& FilePath : FoundFiles)
+	Async(EAsyncExecution::ThreadPool, [this, WeakGeneration, Generation, SaveDir]()
 	{
-		FString RelativePath = FilePath;
-		FPaths::MakePathRelativeTo(RelativePath, *SaveDir);
-		RelativePath = FPaths::ChangeExtension(RelativePath, TEXT(""));
+		auto IsOutdated = [WeakGeneration, Generation]()
+		{
+			const TSharedPtr<FThreadSafeCounter> CurrentGeneration = WeakGeneration.Pin();
+			return !CurrentGeneration || CurrentGeneration->GetValue() != Generation;
+		};
+
+		auto PushBatch = [this, WeakGeneration, Generation, IsOutdated](TArray<FSaveFileEntryPtr>&& Batch, bool bFinished)
+		{
+			AsyncTask(ENamedThreads::GameThread, [this, IsOutdated, Batch = MoveTemp(Batch), bFinished]()
+			{
+				if (!IsOutdated())
+					AddScannedFiles(Batch, bFinished);
+			});
+		};
+
+		TArray<FSaveFileEntryPtr> Batch;
+		IFileManager::Get().IterateDirectoryStatRecursively(*SaveDir, [&](const TCHAR* FilePath, const FFileStatData& StatData)
+		{
+			FString RelativePath = FilePath;
+			if (StatData.bIsDirectory || FPaths::GetExtension(RelativePath) != TEXT("sav"))
+				return true;
+
+			FPaths::MakePathRelativeTo(RelativePath, *SaveDir);
+			RelativePath = FPaths::ChangeExtension(RelativePath, TEXT(""));
+
+			FSaveFileEntryPtr Entry = MakeShared<FSaveFileEntry>();
+			Entry->SlotName = FName(*RelativePath);
+			Entry->Size = StatData.FileSize;
+			Entry->TimeStamp = StatData.ModificationTime;
+			Batch.Add(Entry);
 
-		AllOptions.Add(FName(*RelativePath));
+			if (Batch.Num() >= SaveEditor::ScanBatchSize)
+			{
+				PushBatch(MoveTemp(Batch), false);
+				Batch.Reset();
+			}
+			return !IsOutdated();
+		});
+
+		PushBatch(MoveTemp(Batch), true);
+	});
+
+	LoadSelectedSaveAsync();
+}
+
+void FSaveSystemEditorModule::AddScannedFiles(const TArray<FSaveFileEntryPtr>& Batch, bool bFinished)
+{
+	AllSaveFiles.Append(Batch);
+	for (const FSaveFileEntryPtr& Entry : Batch)
+	{
+		if (PassesFilter(*Entry, FilterString))
+			FilteredSaveFiles.Add(Entry);
 	}
 
-	return AllOptions;
+	bScanning = !bFinished;
+	if (SaveListView.IsValid())
+		SaveListView->RequestListRefresh();
 }
 
-void FSaveSystemEditorModule::RefreshAllData()
+void FSaveSystemEditorModule::SetFilterText(const FText& NewText)
+{
+	FilterString = NewText.ToString();
+	const int32 Generation = ++FilterGeneration;
+	TWeakPtr<FThreadSafeCounter> WeakGeneration = ScanGeneration;
+
+	//The scan keeps appending while this runs, files after the snapshot are filtered once the result arrives
+	Async(EAsyncExecution::ThreadPool, [this, WeakGeneration, Generation, Snapshot = AllSaveFiles, Filter = FilterString]()
+	{
+		TArray<FSaveFileEntryPtr> Result;
+		for (const FSaveFileEntryPtr& Entry : Snapshot)
+		{
+			if (PassesFilter(*Entry, Filter))
+				Result.Add(Entry);
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [this, WeakGeneration, Generation, Result = MoveTemp(Result), NumFiltered = Snapshot.Num()]() mutable
+		{
+			if (WeakGeneration.IsValid() && Generation == FilterGeneration)
+				ApplyFilterResult(MoveTemp(Result), NumFiltered);
+		});
+	});
+}
+
+void FSaveSystemEditorModule::ApplyFilterResult(TArray<FSaveFileEntryPtr>&& Result, int32 NumFiltered)
+{
+	//A refresh started in between, the scan filters its files itself
+	if (NumFiltered > AllSaveFiles.Num())
+		return;
+
+	FilteredSaveFiles = MoveTemp(Result);
+	for (int32 Index = NumFiltered; Index < AllSaveFiles.Num(); Index++)
+	{
+		if (PassesFilter(*AllSaveFiles[Index], FilterString))
+			FilteredSaveFiles.Add(AllSaveFiles[Index]);
+	}
+
+	if (SaveListView.IsValid())
+		SaveListView->RequestListRefresh();
+}
+
+bool FSaveSystemEditorModule::PassesFilter(const FSaveFileEntry& Entry, const FString& Filter) const
+{
+	return Filter.IsEmpty() || Entry.SlotName.ToString().Contains(Filter);
+}
+
+void FSaveSystemEditorModule::LoadSelectedSaveAsync()
 {
-	FoundSavePaths = GetAllOptions();
-	SetupModifiableSave();
+	const int32 Generation = ++LoadGeneration;
+	TWeakPtr<FThreadSafeCounter> WeakGeneration = ScanGeneration;
+
+	CurrentSelectedObject = nullptr;
+	if (DetailsView.IsValid())
+		DetailsView->SetObject(nullptr);
+
+	SelectedSummary = FSaveSlotSummary();
+	SelectedSummary.bLoading = true;
+
+	//The summary is filled from the file stats and the slot header before the slot itself is read
+	const FString FilePath = USaveSubSystem::GetSlotFilePath(CurrentSelectedPath.ToString());
+	Async(EAsyncExecution::ThreadPool, [this, WeakGeneration, Generation, FilePath]()
+	{
+		const FFileStatData StatData = IFileManager::Get().GetStatData(*FilePath);
+		int32 ObjectCount = INDEX_NONE;
+		USaveSubSystem::ReadSlotObjectCount(FilePath, ObjectCount);
+		AsyncTask(ENamedThreads::GameThread, [this, WeakGeneration, Generation, StatData, ObjectCount]()
+		{
+			if (!WeakGeneration.IsValid() || Generation != LoadGeneration || !StatData.bIsValid)
+				return;
+
+			SelectedSummary.Size = StatData.FileSize;
+			SelectedSummary.TimeStamp = StatData.ModificationTime;
+			SelectedSummary.ObjectCount = ObjectCount;
+		});
+
+		TArray<uint8> Payload;
+		bool bCorrupt = false;
+		const bool bRead = USaveSubSystem::ReadVerifiedSlotFile(FilePath, Payload, bCorrupt);
+
+		AsyncTask(ENamedThreads::GameThread, [this, WeakGeneration, Generation, Payload = MoveTemp(Payload), bRead]() mutable
+		{
+			if (WeakGeneration.IsValid() && Generation == LoadGeneration)
+				OnSelectedSaveLoaded(MoveTemp(Payload), bRead);
+		});
+	});
 }
 
-bool FSaveSystemEditorModule::SetupModifiableSave()
+void FSaveSystemEditorModule::OnSelectedSaveLoaded(TArray<uint8>&& Payload, bool bRead)
 {
-	TObjectPtr<USaveGame> LoadedObject = UGameplayStatics::LoadGameFromSlot(CurrentSelectedPath.ToString(), 0);
+	//Deserializing creates objects, so only this part runs on the game thread.
+	//Unreadable slots go through the regular path to get the backup fallback.
+	TObjectPtr<USaveGame> LoadedObject = bRead
+		? UGameplayStatics::LoadGameFromMemory(Payload)
+		: USaveSubSystem::LoadGameFromSlot(CurrentSelectedPath.ToString());
+
 	DetailsView->SetObject(LoadedObject);
 	CurrentSelectedObject = LoadedObject;
-	return LoadedObject != nullptr;
+
+	SelectedSummary.bLoading = false;
+	SelectedSummary.bFailed = LoadedObject == nullptr;
+	//Slots written before the header stored the count
+	if (const UGeneralSaveGame* GeneralSave = Cast<UGeneralSaveGame>(LoadedObject))
+		SelectedSummary.ObjectCount = GeneralSave->GetNumData();
+}
+
+FText FSaveSystemEditorModule::GetSummaryText() const
+{
+	const FString SizeString = SelectedSummary.Size >= 0 ? FText::AsMemory(SelectedSummary.Size).ToString() : TEXT("-");
+	const FString TimeString = SelectedSummary.Size >= 0 ? SelectedSummary.TimeStamp.ToString() : TEXT("-");
+	const FString ObjectString = SelectedSummary.ObjectCount >= 0 ? FString::FromInt(SelectedSummary.ObjectCount) : TEXT("-");
+
+	FString StateString;
+	if (SelectedSummary.bLoading)
+		StateString = TEXT("  (Loading...)");
+	else if (SelectedSummary.bFailed)
+		StateString = TEXT("  (Failed to load)");
+
+	return FText::FromString(FString::Printf(TEXT("%s   Size: %s   Objects: %s   Modified: %s%s"),
+		*CurrentSelectedPath.ToString(), *SizeString, *ObjectString, *TimeString, *StateString));
 }
 
-TSharedRef<SWidget> FSaveSystemEditorModule::OnGenerateWidget(FName Selected)
+TSharedRef<ITableRow> FSaveSystemEditorModule::OnGenerateRow(FSaveFileEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable)
 {
-	return SNew(STextBlock)
-	   .Text(FText::FromName(Selected));
+	return SNew(STableRow<FSaveFileEntryPtr>, OwnerTable)
+	[
+		SNew(STextBlock)
+		.Text(FText::FromName(Entry->SlotName))
+	];
 }
 
-void FSaveSystemEditorModule::OnSaveSelectionChanged(FName NewValue, ESelectInfo::Type SelectInfo)
+void FSaveSystemEditorModule::OnSaveSelectionChanged(FSaveFileEntryPtr NewValue, ESelectInfo::Type SelectInfo)
 {
-	CurrentSelectedPath = NewValue;
-	SetupModifiableSave();
+	if (!NewValue.IsValid())
+		return;
+
+	CurrentSelectedPath = NewValue->SlotName;
+	LoadSelectedSaveAsync();
 }
 
 TSharedRef<class SDockTab> FSaveSystemEditorModule::OnSpawnSaveEditorTab(const class FSpawnTabArgs& SpawnTabArgs)
 {
 	FPropertyEditorModule& PropertyEditorModule = FModuleManager::LoadModuleChecked<FPropertyEditorModule>("PropertyEditor");
-	
+
 	FDetailsViewArgs DetailsViewArgs;
 	DetailsViewArgs.bAllowSearch = false;
 	DetailsViewArgs.bForceHiddenPropertyVisibility = true;
@@ -88,77 +264,108 @@ TSharedRef<class SDockTab> FSaveSystemEditorModule::OnSpawnSaveEditorTab(const c
 	DetailsViewArgs.bUpdatesFromSelection = false;
 	DetailsViewArgs.bShowPropertyMatrixButton = false;
 	DetailsViewArgs.ViewIdentifier = "SaveEditor";
-	
+
 	DetailsView = PropertyEditorModule.CreateDetailView(DetailsViewArgs);
 	CurrentSelectedPath = FName(USaveSubSystem::GetSoloSaveName());
-	
+
+	SAssignNew(SaveListView, SListView<FSaveFileEntryPtr>)
+	.ListItemsSource(&FilteredSaveFiles)
+	.SelectionMode(ESelectionMode::Single)
+	.OnGenerateRow_Raw(this, &FSaveSystemEditorModule::OnGenerateRow)
+	.OnSelectionChanged_Raw(this, &FSaveSystemEditorModule::OnSaveSelectionChanged);
+
 	RefreshAllData();
-	
+
 	return SNew(SDockTab)
 		.TabRole(ETabRole::NomadTab)
 		[
-			SNew(SVerticalBox)
-			
-			+ SVerticalBox::Slot()
-			.AutoHeight()
+			SNew(SSplitter)
+
+			+ SSplitter::Slot()
+			.Value(0.3f)
 			[
-				SNew(SHorizontalBox)
+				SNew(SVerticalBox)
 
-				+ SHorizontalBox::Slot()
-				.FillWidth(1)
+				+ SVerticalBox::Slot()
+				.AutoHeight()
 				[
-					SNew(SComboBox<FName>)
-					.OptionsSource(&FoundSavePaths)
-					.OnGenerateWidget_Raw(this, &FSaveSystemEditorModule::OnGenerateWidget)
-					.OnSelectionChanged_Raw(this, &FSaveSystemEditorModule::OnSaveSelectionChanged)
-					[
-						SNew(STextBlock)
-						.Text_Lambda([this]()
-						{
-							return CurrentSelectedObject.IsValid()
-								? FText::FromName(CurrentSelectedPath)
-								: FText::FromString("---");
-						})
-					]
+					SNew(SSearchBox)
+					.OnTextChanged_Raw(this, &FSaveSystemEditorModule::SetFilterText)
 				]
 
-				+SHorizontalBox::Slot()
-				.AutoWidth()
+				+ SVerticalBox::Slot()
+				.AutoHeight()
 				[
-					SNew(SSpacer)
-				]
-				
-				+ SHorizontalBox::Slot()
-				.AutoWidth()
-				[
-					SNew(SButton)
-					.Text(FText::FromString("Refresh"))
-					.ButtonColorAndOpacity(FColor(59, 20, 26))
-					.OnClicked_Lambda([this]()
+					SNew(STextBlock)
+					.Text_Lambda([this]()
 					{
-						RefreshAllData();
-						return FReply::Handled();
+						return FText::FromString(FString::Printf(TEXT("%d / %d Saves%s"), FilteredSaveFiles.Num(), AllSaveFiles.Num(), bScanning ? TEXT(" (Scanning...)") : TEXT("")));
 					})
 				]
-				+ SHorizontalBox::Slot()
-				.AutoWidth()
+
+				+ SVerticalBox::Slot()
+				.FillHeight(1.0f)
 				[
-					SNew(SButton)
-					.Text(FText::FromString("Save"))
-					.ButtonColorAndOpacity(FColor(22, 48, 29))
-					.OnClicked_Lambda([this]()
-					{
-						if (CurrentSelectedObject.IsValid())
-							UGameplayStatics::SaveGameToSlot(CurrentSelectedObject.Get(), CurrentSelectedPath.ToString(), 0);
-						return FReply::Handled();
-					})
+					SaveListView.ToSharedRef()
 				]
 			]
-			
-			+ SVerticalBox::Slot()
-			.FillHeight(1.0f)
+
+			+ SSplitter::Slot()
+			.Value(0.7f)
 			[
-				DetailsView.ToSharedRef()
+				SNew(SVerticalBox)
+
+				+ SVerticalBox::Slot()
+				.AutoHeight()
+				[
+					SNew(SHorizontalBox)
+
+					+ SHorizontalBox::Slot()
+					.FillWidth(1)
+					.VAlign(VAlign_Center)
+					[
+						SNew(STextBlock)
+						.Text_Raw(this, &FSaveSystemEditorModule::GetSummaryText)
+					]
+
+					+SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SSpacer)
+					]
+
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SButton)
+						.Text(FText::FromString("Refresh"))
+						.ButtonColorAndOpacity(FColor(59, 20, 26))
+						.OnClicked_Lambda([this]()
+						{
+							RefreshAllData();
+							return FReply::Handled();
+						})
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					[
+						SNew(SButton)
+						.Text(FText::FromString("Save"))
+						.ButtonColorAndOpacity(FColor(22, 48, 29))
+						.OnClicked_Lambda([this]()
+						{
+							if (CurrentSelectedObject.IsValid())
+								USaveSubSystem::SaveGameToSlot(CurrentSelectedObject.Get(), CurrentSelectedPath.ToString());
+							return FReply::Handled();
+						})
+					]
+				]
+
+				+ SVerticalBox::Slot()
+				.FillHeight(1.0f)
+				[
+					DetailsView.ToSharedRef()
+				]
 			]
 		];
 }
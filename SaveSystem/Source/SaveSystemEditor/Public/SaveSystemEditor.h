@@ -1,9 +1,30 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
 #include "Modules/ModuleManager.h"
+#include "Types/SlateEnums.h"
 
 class USaveGame;
+class ITableRow;
+class STableViewBase;
+template <typename ItemType> class SListView;
+
+struct FSaveFileEntry
+{
+    FName SlotName;
+    int64 Size = 0;
+    FDateTime TimeStamp;
+};
+
+struct FSaveSlotSummary
+{
+    int64 Size = INDEX_NONE;
+    FDateTime TimeStamp;
+    int32 ObjectCount = INDEX_NONE;
+    bool bLoading = false;
+    bool bFailed = false;
+};
 
 class FSaveSystemEditorModule : public IModuleInterface
 {
@@ -14,22 +35,42 @@ public:
 protected:
 
     TSharedRef<class SDockTab> OnSpawnSaveEditorTab(const class FSpawnTabArgs& SpawnTabArgs);
-    
+
     static const FName SaveEditorTabName;
 
 private:
 
-    TArray<FName> GetAllOptions() const;
+    using FSaveFileEntryPtr = TSharedPtr<FSaveFileEntry>;
 
+    //File list - scanned and filtered on background threads, populated in batches
     void RefreshAllData();
-    bool SetupModifiableSave();
+    void AddScannedFiles(const TArray<FSaveFileEntryPtr>& Batch, bool bFinished);
+    void SetFilterText(const FText& NewText);
+    void ApplyFilterResult(TArray<FSaveFileEntryPtr>&& Result, int32 NumFiltered);
+    bool PassesFilter(const FSaveFileEntry& Entry, const FString& Filter) const;
+
+    //Selected slot - read and verified on a background thread, deserialized on the game thread
+    void LoadSelectedSaveAsync();
+    void OnSelectedSaveLoaded(TArray<uint8>&& Payload, bool bRead);
+    FText GetSummaryText() const;
 
-    TSharedRef<SWidget> OnGenerateWidget(FName Selected);
-    void OnSaveSelectionChanged(FName NewValue, ESelectInfo::Type SelectInfo);
+    TSharedRef<ITableRow> OnGenerateRow(FSaveFileEntryPtr Entry, const TSharedRef<STableViewBase>& OwnerTable);
+    void OnSaveSelectionChanged(FSaveFileEntryPtr NewValue, ESelectInfo::Type SelectInfo);
 
     //TEMP REFS - NEED TO BE MOVED
     TWeakObjectPtr<USaveGame> CurrentSelectedObject = nullptr;
     FName CurrentSelectedPath = "";
     TSharedPtr<IDetailsView> DetailsView = nullptr;
-    TArray<FName> FoundSavePaths;
+    TSharedPtr<SListView<FSaveFileEntryPtr>> SaveListView = nullptr;
+
+    TArray<FSaveFileEntryPtr> AllSaveFiles;
+    TArray<FSaveFileEntryPtr> FilteredSaveFiles;
+    FString FilterString;
+    FSaveSlotSummary SelectedSummary;
+    bool bScanning = false;
+
+    //Results of outdated background work are dropped
+    TSharedPtr<FThreadSafeCounter> ScanGeneration = MakeShared<FThreadSafeCounter>();
+    int32 FilterGeneration = 0;
+    int32 LoadGeneration = 0;
 };